@@ -0,0 +1,420 @@
+#include "AllocAudit.h"
+
+#ifdef BREAKOUT_ALLOC_AUDIT
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#pragma intrinsic(_ReturnAddress)
+#define CALLER_ADDRESS() _ReturnAddress()
+#else
+#define CALLER_ADDRESS() __builtin_return_address(0)
+#endif
+
+namespace
+{
+	const int phase_count = static_cast<int>(FramePhase::COUNT);
+	const char* const phase_names[phase_count] = { "other", "input", "update", "blocks", "render" };
+
+	/**
+	*  Counts for the frame in progress. Any thread can add to these.
+	*/
+	struct FrameCounts
+	{
+		std::atomic<uint64_t> allocations;
+		std::atomic<uint64_t> bytes;
+		std::atomic<uint64_t> frees;
+		std::atomic<uint64_t> violations;
+	};
+
+	/**
+	*  Counts over every finished frame. Only touched by the thread
+	*  that ends frames.
+	*/
+	struct PhaseTotals
+	{
+		uint64_t allocations = 0;
+		uint64_t bytes = 0;
+		uint64_t frees = 0;
+		uint64_t violations = 0;
+		uint64_t peak_allocations = 0;   /**< Most allocations in one frame. */
+		uint64_t frames_allocating = 0;  /**< Frames with at least one allocation. */
+	};
+
+	/**
+	*  One slot of the call site table. Slots are claimed by swapping
+	*  the address in, so no lock or allocation is needed.
+	*/
+	struct CallSite
+	{
+		std::atomic<void*>    address;
+		std::atomic<uint64_t> allocations;
+		std::atomic<uint64_t> bytes;
+	};
+
+	const int max_call_sites = 4096;
+
+	FrameCounts current[phase_count];
+	PhaseTotals totals[phase_count];
+	CallSite    call_sites[max_call_sites];
+	std::atomic<uint64_t> untracked_sites(0);  /**< Allocations made once the table is full. */
+	std::atomic<bool>     fail_on_violation(false);
+	uint64_t frames = 0;
+
+	thread_local FramePhase thread_phase = FramePhase::OTHER;
+	thread_local bool thread_free = false;
+	thread_local bool in_audit = false;  /**< Stops anything the audit itself allocates being counted. */
+
+	void countCallSite(void* address, size_t size)
+	{
+		size_t slot = (reinterpret_cast<uintptr_t>(address) >> 4) % max_call_sites;
+		for (int probe = 0; probe < max_call_sites; probe++)
+		{
+			CallSite& site = call_sites[(slot + probe) % max_call_sites];
+			void* held = site.address.load(std::memory_order_relaxed);
+			if (held == nullptr &&
+				site.address.compare_exchange_strong(held, address, std::memory_order_relaxed))
+			{
+				held = address;
+			}
+
+			if (held == address)
+			{
+				site.allocations.fetch_add(1, std::memory_order_relaxed);
+				site.bytes.fetch_add(size, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		untracked_sites.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void countAllocation(size_t size, void* caller)
+	{
+		if (in_audit)
+		{
+			return;
+		}
+
+		FrameCounts& counts = current[static_cast<int>(thread_phase)];
+		counts.allocations.fetch_add(1, std::memory_order_relaxed);
+		counts.bytes.fetch_add(size, std::memory_order_relaxed);
+		countCallSite(caller, size);
+
+		if (thread_free)
+		{
+			counts.violations.fetch_add(1, std::memory_order_relaxed);
+			if (fail_on_violation.load(std::memory_order_relaxed))
+			{
+				in_audit = true;
+				fprintf(stderr, "allocation of %u bytes from %p in the allocation free %s phase\n",
+					static_cast<unsigned>(size), caller, phase_names[static_cast<int>(thread_phase)]);
+				abort();
+			}
+		}
+	}
+
+	void countFree()
+	{
+		if (!in_audit)
+		{
+			current[static_cast<int>(thread_phase)].frees.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void* allocate(size_t size)
+	{
+		return malloc(size ? size : 1);
+	}
+
+#ifdef __cpp_aligned_new
+	void* allocateAligned(size_t size, std::align_val_t alignment)
+	{
+		size = size ? size : 1;
+#ifdef _WIN32
+		return _aligned_malloc(size, static_cast<size_t>(alignment));
+#else
+		void* p = nullptr;
+		return posix_memalign(&p, static_cast<size_t>(alignment), size) == 0 ? p : nullptr;
+#endif
+	}
+
+	void freeAligned(void* p)
+	{
+#ifdef _WIN32
+		_aligned_free(p);
+#else
+		free(p);
+#endif
+	}
+#endif
+}
+
+AllocScope::AllocScope(FramePhase phase, bool allocation_free) :
+	previous_phase(thread_phase), previous_free(thread_free)
+{
+	thread_phase = phase;
+	thread_free = allocation_free;
+}
+
+AllocScope::~AllocScope()
+{
+	thread_phase = previous_phase;
+	thread_free = previous_free;
+}
+
+/**
+*   @brief   Moves the frame's counts into the totals.
+*   @details Counts from other threads that land while this runs go
+			 into the next frame, which is close enough for a report.
+*   @return  void
+*/
+void allocAuditEndFrame()
+{
+	for (int i = 0; i < phase_count; i++)
+	{
+		uint64_t allocations = current[i].allocations.exchange(0);
+		totals[i].allocations += allocations;
+		totals[i].bytes += current[i].bytes.exchange(0);
+		totals[i].frees += current[i].frees.exchange(0);
+		totals[i].violations += current[i].violations.exchange(0);
+		totals[i].peak_allocations = std::max(totals[i].peak_allocations, allocations);
+		totals[i].frames_allocating += allocations > 0 ? 1 : 0;
+	}
+
+	frames++;
+}
+
+void allocAuditFailOnViolation(bool fail)
+{
+	fail_on_violation = fail;
+}
+
+/**
+*   @brief   Writes the audit report.
+*   @details The busiest call sites are listed by address, which is
+			 the instruction after the call to operator new. Look them
+			 up in the debugger or the linker map, most will be inside
+			 std:: code inlined into the function that used it.
+*   @return  False if the file couldn't be opened.
+*/
+bool allocAuditReport(const char* path)
+{
+	in_audit = true;
+	FILE* report = fopen(path, "w");
+	if (!report)
+	{
+		in_audit = false;
+		return false;
+	}
+
+	uint64_t frame_count = frames > 0 ? frames : 1;
+	fprintf(report, "frames %llu\n\n", static_cast<unsigned long long>(frames));
+	fprintf(report, "phase     allocs/frame  peak/frame  frames allocating  bytes/frame  frees/frame  violations\n");
+	for (int i = 0; i < phase_count; i++)
+	{
+		const PhaseTotals& phase = totals[i];
+		fprintf(report, "%-8s  %12.2f  %10llu  %17llu  %11.0f  %11.2f  %10llu\n", phase_names[i],
+			double(phase.allocations) / frame_count,
+			static_cast<unsigned long long>(phase.peak_allocations),
+			static_cast<unsigned long long>(phase.frames_allocating),
+			double(phase.bytes) / frame_count,
+			double(phase.frees) / frame_count,
+			static_cast<unsigned long long>(phase.violations));
+	}
+
+	// the busiest sites, without allocating anything to sort them
+	const int top_count = 20;
+	int top[top_count];
+	int found = 0;
+	for (int i = 0; i < max_call_sites; i++)
+	{
+		if (!call_sites[i].address.load())
+		{
+			continue;
+		}
+
+		uint64_t allocations = call_sites[i].allocations.load();
+		int at = found < top_count ? found++ : top_count;
+		while (at > 0 && call_sites[top[at - 1]].allocations.load() < allocations)
+		{
+			if (at < top_count)
+			{
+				top[at] = top[at - 1];
+			}
+			at--;
+		}
+
+		if (at < top_count)
+		{
+			top[at] = i;
+		}
+	}
+
+	fprintf(report, "\ntop call sites\n       allocations        bytes  address\n");
+	for (int i = 0; i < found; i++)
+	{
+		const CallSite& site = call_sites[top[i]];
+		fprintf(report, "%18llu  %11llu  %p\n",
+			static_cast<unsigned long long>(site.allocations.load()),
+			static_cast<unsigned long long>(site.bytes.load()),
+			site.address.load());
+	}
+
+	if (untracked_sites.load() > 0)
+	{
+		fprintf(report, "%18llu  from sites after the table filled\n",
+			static_cast<unsigned long long>(untracked_sites.load()));
+	}
+
+	fclose(report);
+	in_audit = false;
+	return true;
+}
+
+void* operator new(size_t size)
+{
+	countAllocation(size, CALLER_ADDRESS());
+	void* p = allocate(size);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	countAllocation(size, CALLER_ADDRESS());
+	void* p = allocate(size);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	countAllocation(size, CALLER_ADDRESS());
+	return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	countAllocation(size, CALLER_ADDRESS());
+	return allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	if (p)
+	{
+		countFree();
+		free(p);
+	}
+}
+
+void operator delete[](void* p) noexcept
+{
+	operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	operator delete(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	operator delete(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	operator delete(p);
+}
+
+// types aligned past the default, only called in C++17 builds
+#ifdef __cpp_aligned_new
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	countAllocation(size, CALLER_ADDRESS());
+	void* p = allocateAligned(size, alignment);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	countAllocation(size, CALLER_ADDRESS());
+	void* p = allocateAligned(size, alignment);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	countAllocation(size, CALLER_ADDRESS());
+	return allocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	countAllocation(size, CALLER_ADDRESS());
+	return allocateAligned(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	if (p)
+	{
+		countFree();
+		freeAligned(p);
+	}
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+	operator delete(p, alignment);
+}
+
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(p, alignment);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(p, alignment);
+}
+
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	operator delete(p, alignment);
+}
+
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	operator delete(p, alignment);
+}
+#endif
+
+#endif
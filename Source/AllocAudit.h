@@ -0,0 +1,85 @@
+#pragma once
+#include <stddef.h>
+
+/**
+*  The parts of a frame allocations are counted against.
+*/
+enum class FramePhase
+{
+	OTHER,    /**< Anything outside a marked phase, such as loading. */
+	INPUT,    /**< Key and mouse handlers. */
+	UPDATE,   /**< BreakoutGame::update, including the simulation. */
+	BLOCKS,   /**< Copying the blocks onto their entities. */
+	RENDER,   /**< BreakoutGame::render. */
+	COUNT
+};
+
+/**
+*  Allocation audit mode.
+*  Defining BREAKOUT_ALLOC_AUDIT for the whole build replaces the
+*  global operator new and delete with versions that count every
+*  allocation, and the bytes asked for, against the frame phase the
+*  calling thread is in and the code that called new. A report of
+*  the per-frame counts and the busiest call sites is written when
+*  the game exits. A phase can be marked allocation free, and with
+*  allocAuditFailOnViolation on, any allocation inside it aborts the
+*  game with a message naming the phase. Without the define every
+*  function here is an empty inline and the scopes compile away.
+*/
+#ifdef BREAKOUT_ALLOC_AUDIT
+
+/**
+*  Puts the calling thread in a frame phase until it goes out of scope.
+*  Scopes can be nested, the innermost wins.
+*/
+class AllocScope
+{
+public:
+	/**
+	*  @param [in] phase The phase to count allocations against.
+	*  @param [in] allocation_free True if nothing in the scope should
+	*  allocate.
+	*/
+	explicit AllocScope(FramePhase phase, bool allocation_free = false);
+	~AllocScope();
+
+	AllocScope(const AllocScope&) = delete;
+	AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+	FramePhase previous_phase;
+	bool       previous_free;
+};
+
+/**
+*  Closes the counts for the frame that has just finished.
+*  Call once per frame, before anything in the next one.
+*/
+void allocAuditEndFrame();
+
+/**
+*  Sets whether an allocation in an allocation free scope aborts.
+*  Off by default, when violations are only counted.
+*/
+void allocAuditFailOnViolation(bool fail);
+
+/**
+*  Writes the per-phase counts and the busiest call sites.
+*  @param [in] path The file to write.
+*  @return false if the file couldn't be opened.
+*/
+bool allocAuditReport(const char* path);
+
+#else
+
+class AllocScope
+{
+public:
+	explicit AllocScope(FramePhase, bool = false) {}
+};
+
+inline void allocAuditEndFrame() {}
+inline void allocAuditFailOnViolation(bool) {}
+inline bool allocAuditReport(const char*) { return true; }
+
+#endif
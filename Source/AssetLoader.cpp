@@ -0,0 +1,194 @@
+#include <string.h>
+#include <atomic>
+#include <chrono>
+
+#include "AssetLoader.h"
+#include "FilePath.h"
+
+AssetLoader::AssetLoader(int threads) : pool(threads)
+{
+}
+
+AssetLoader::~AssetLoader()
+{
+	if (ready.valid())
+	{
+		ready.wait();
+	}
+}
+
+std::shared_future<bool> AssetLoader::start(const AssetManifest& to_load)
+{
+	if (ready.valid())
+	{
+		ready.wait();
+	}
+
+	manifest = to_load;
+	ready = std::async(std::launch::async, [this]() { return loadAll(); }).share();
+	return ready;
+}
+
+/**
+*   @brief   Loads every file, run on a background thread.
+*   @details The atlas file is small and decides which PNGs are
+			 needed, so it is read first. Files found in the pack
+			 need no work, the rest are shared out to the pool. Each
+			 worker pulls the next file from a shared counter rather
+			 than taking a fixed slice, so one large file doesn't
+			 leave the other workers idle.
+*   @return  True if every file loaded.
+*/
+bool AssetLoader::loadAll()
+{
+	auto start_time = std::chrono::steady_clock::now();
+
+	atlas_data.clear();
+	pack.close();
+	files.clear();
+	lookup.clear();
+
+	// the atlas and pack are optional, without them every texture loads from its own file
+	for (const AssetEntry& entry : manifest.entries())
+	{
+		if (entry.type == AssetEntry::Type::ATLAS && atlas_data.pageCount() == 0)
+		{
+			atlas_data.load(entry.path);
+		}
+		else if (entry.type == AssetEntry::Type::PACK && !pack.isOpen())
+		{
+			pack.open(entry.path);
+		}
+	}
+
+	for (int page = 0; page < atlas_data.pageCount(); page++)
+	{
+		addFile(atlas_data.pagePath(page));
+	}
+
+	for (const AssetEntry& entry : manifest.entries())
+	{
+		if (entry.type == AssetEntry::Type::TEXTURE &&
+			!atlas_data.find(TextureAtlas::spriteName(entry.path)))
+		{
+			addFile(entry.path);
+		}
+	}
+
+	views.assign(files.size(), ImageView());
+	images.assign(files.size(), Image());
+	decoded.assign(files.size(), 0);
+
+	std::vector<int> to_decode;
+	for (int i = 0; i < static_cast<int>(files.size()); i++)
+	{
+		if (pack.find(files[i], views[i]))
+		{
+			decoded[i] = 1;
+		}
+		else
+		{
+			to_decode.push_back(i);
+		}
+	}
+	packed_count = static_cast<int>(files.size() - to_decode.size());
+
+	std::atomic<int> next(0);
+	int count = static_cast<int>(to_decode.size());
+	pool.parallelFor(pool.size(), [&](int, int, int)
+	{
+		for (int job = next++; job < count; job = next++)
+		{
+			int i = to_decode[job];
+			Image& image = images[i];
+			decoded[i] = loadPng(files[i], image) ? 1 : 0;
+			views[i].width = image.width;
+			views[i].height = image.height;
+			views[i].pixels = image.pixels.data();
+		}
+	});
+
+	bool ok = true;
+	for (char file_ok : decoded)
+	{
+		ok = ok && file_ok;
+	}
+
+	load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+	return ok;
+}
+
+void AssetLoader::addFile(const std::string& path)
+{
+	std::string key = normalisePath(path);
+	if (lookup.find(key) == lookup.end())
+	{
+		lookup[key] = static_cast<int>(files.size());
+		files.push_back(path);
+	}
+}
+
+const ImageView* AssetLoader::image(const std::string& path) const
+{
+	auto it = lookup.find(normalisePath(path));
+	if (it == lookup.end() || !decoded[it->second])
+	{
+		return nullptr;
+	}
+	return &views[it->second];
+}
+
+const std::vector<std::string>& AssetLoader::fileList() const
+{
+	return files;
+}
+
+int AssetLoader::packedCount() const
+{
+	return packed_count;
+}
+
+const TextureAtlas& AssetLoader::atlas() const
+{
+	return atlas_data;
+}
+
+bool AssetLoader::buildCollisionMask(const std::string& texture_file_name, CollisionMask& mask) const
+{
+	const AtlasRegion* region = atlas_data.find(TextureAtlas::spriteName(texture_file_name));
+	if (!region)
+	{
+		const ImageView* source = image(texture_file_name);
+		if (!source)
+		{
+			return false;
+		}
+
+		mask.build(source->pixels, source->width, source->height, 4);
+		return true;
+	}
+
+	const ImageView* page = image(atlas_data.pagePath(region->page));
+	if (!page || region->x + region->width > page->width ||
+		region->y + region->height > page->height)
+	{
+		return false;
+	}
+
+	size_t row_bytes = static_cast<size_t>(region->width) * 4;
+	size_t page_stride = static_cast<size_t>(page->width) * 4;
+	std::vector<unsigned char> cropped(row_bytes * region->height);
+	for (int row = 0; row < region->height; row++)
+	{
+		const unsigned char* source = page->pixels + (region->y + row) * page_stride + region->x * 4;
+		memcpy(&cropped[row * row_bytes], source, row_bytes);
+	}
+
+	mask.build(cropped.data(), region->width, region->height, 4);
+	return true;
+}
+
+double AssetLoader::loadSeconds() const
+{
+	return load_seconds;
+}
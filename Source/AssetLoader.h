@@ -0,0 +1,108 @@
+#pragma once
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetManifest.h"
+#include "AssetPack.h"
+#include "CollisionMask.h"
+#include "PngCodec.h"
+#include "TextureAtlas.h"
+#include "ThreadPool.h"
+
+/**
+*  Reads and decodes a manifest's files on a worker pool.
+*  start() returns at once. The loading runs in the background, so
+*  the game can open its window while files are read, and the future
+*  it returns is waited on before play begins. Workers take the next
+*  file as they finish the last one, so startup is bounded by the
+*  slowest file rather than the sum of them all.
+*
+*  Textures have to be made on the render thread, so that last step
+*  is left to the game. TextureCache uploads the pixels kept here in
+*  place of loading each file again, and they also serve the work
+*  done on the CPU, such as collision masks.
+*
+*  When the manifest lists an AssetPack, images found in it are used
+*  straight from the mapped file and only the rest are decoded. An
+*  image whose PNG has changed since it was packed is decoded again.
+*/
+class AssetLoader
+{
+public:
+	/**
+	*  @param [in] threads Threads to decode with, 0 for one per core.
+	*/
+	explicit AssetLoader(int threads = 0);
+
+	/**
+	*  Waits for any loading still running.
+	*/
+	~AssetLoader();
+
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+
+	/**
+	*  Starts loading every file in a manifest.
+	*  The first atlas listed is read first, and its pages are decoded
+	*  along with any texture not packed into it. A missing atlas isn't
+	*  an error, the textures are loaded from their own files. Likewise
+	*  a missing or stale pack only means more files are decoded. Nothing
+	*  else may be called until the future is ready.
+	*  @return a future that becomes true once every file has loaded,
+	*  or false if any failed.
+	*/
+	std::shared_future<bool> start(const AssetManifest& manifest);
+
+	/**
+	*  The pixels of a file, decoded or from the pack.
+	*  @return the image, or nullptr if the file wasn't loaded.
+	*/
+	const ImageView* image(const std::string& path) const;
+
+	/**
+	*  Every image file the last start() loaded, atlas pages first.
+	*/
+	const std::vector<std::string>& fileList() const;
+
+	/**
+	*  How many of those files came from the pack.
+	*/
+	int packedCount() const;
+
+	/**
+	*  The manifest's atlas, empty if it didn't list one.
+	*/
+	const TextureAtlas& atlas() const;
+
+	/**
+	*  Bakes a texture's alpha channel into a mask, from its region of
+	*  the atlas when it was packed into it.
+	*  @return false if the texture wasn't loaded.
+	*/
+	bool buildCollisionMask(const std::string& texture_file_name, CollisionMask& mask) const;
+
+	/**
+	*  Wall clock time the last start() took to finish, in seconds.
+	*/
+	double loadSeconds() const;
+
+private:
+	bool loadAll();
+	void addFile(const std::string& path);
+
+	ThreadPool pool;
+	AssetManifest manifest;
+	TextureAtlas  atlas_data;
+	AssetPack     pack;
+	std::vector<std::string> files;
+	std::vector<ImageView>   views;       /**< Into images or the pack. */
+	std::vector<Image>       images;
+	std::vector<char>        decoded;     /**< One flag per file, char so workers don't share bits. */
+	std::unordered_map<std::string, int> lookup;  /**< Normalised path to index in files. */
+	std::shared_future<bool> ready;
+	double load_seconds = 0;
+	int packed_count = 0;
+};
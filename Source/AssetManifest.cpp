@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "AssetManifest.h"
+
+bool AssetManifest::load(const std::string& path)
+{
+	assets.clear();
+
+	FILE* file = fopen(path.c_str(), "r");
+	if (!file)
+	{
+		return false;
+	}
+
+	bool ok = true;
+	char line[512];
+	while (ok && fgets(line, sizeof(line), file))
+	{
+		char type[32];
+		char name[128];
+		char asset_path[260];
+		if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+		{
+			continue;
+		}
+
+		if (sscanf(line, "%31s %127s %259s", type, name, asset_path) != 3)
+		{
+			ok = false;
+		}
+		else if (!strcmp(type, "texture"))
+		{
+			add(AssetEntry::Type::TEXTURE, name, asset_path);
+		}
+		else if (!strcmp(type, "atlas"))
+		{
+			add(AssetEntry::Type::ATLAS, name, asset_path);
+		}
+		else if (!strcmp(type, "pack"))
+		{
+			add(AssetEntry::Type::PACK, name, asset_path);
+		}
+		else
+		{
+			ok = false;
+		}
+	}
+
+	fclose(file);
+	if (!ok)
+	{
+		assets.clear();
+	}
+	return ok;
+}
+
+void AssetManifest::add(AssetEntry::Type type, const std::string& name, const std::string& path)
+{
+	AssetEntry entry;
+	entry.type = type;
+	entry.name = name;
+	entry.path = path;
+	assets.push_back(entry);
+}
+
+const AssetEntry* AssetManifest::find(const std::string& name) const
+{
+	for (const AssetEntry& entry : assets)
+	{
+		if (entry.name == name)
+		{
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+const std::vector<AssetEntry>& AssetManifest::entries() const
+{
+	return assets;
+}
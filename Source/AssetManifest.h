@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+*  One file listed in an asset manifest.
+*/
+struct AssetEntry
+{
+	enum class Type
+	{
+		TEXTURE,   /**< A PNG, drawn on its own or from the atlas. */
+		ATLAS,     /**< A TextureAtlas file, its pages are loaded with it. */
+		PACK       /**< An AssetPack, images found in it aren't decoded. */
+	};
+
+	Type        type = Type::TEXTURE;
+	std::string name;   /**< What the game asks for it by. */
+	std::string path;
+};
+
+/**
+*  The list of files the game loads at startup.
+*  A text file with one asset per line, the type, a name and a path:
+*
+*      pack    assets Resources/breakout.pack
+*      atlas   sprites Resources/Textures/breakout.atlas
+*      texture paddle  Resources/Textures/puzzlepack/png/paddleBlue.png
+*
+*  Blank lines and lines starting with '#' are skipped. Keeping the
+*  list out of the code lets AssetLoader see every file up front and
+*  load them all at once.
+*/
+class AssetManifest
+{
+public:
+	/**
+	*  Reads a manifest, replacing anything held.
+	*  @return false if the file is missing or a line is malformed.
+	*/
+	bool load(const std::string& path);
+
+	void add(AssetEntry::Type type, const std::string& name, const std::string& path);
+
+	/**
+	*  @return the entry, or nullptr if nothing has that name.
+	*/
+	const AssetEntry* find(const std::string& name) const;
+
+	const std::vector<AssetEntry>& entries() const;
+
+private:
+	std::vector<AssetEntry> assets;
+};
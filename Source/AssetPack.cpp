@@ -0,0 +1,399 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "AssetPack.h"
+#include "FilePath.h"
+
+namespace
+{
+	const char   pack_magic[4] = { 'B', 'P', 'A', 'K' };
+	const size_t pixel_alignment = 16;
+
+	size_t alignUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
+
+AssetPack::~AssetPack()
+{
+	close();
+}
+
+/**
+*   @brief   Maps a pack into memory.
+*   @details Only the header and table are checked, every entry must
+			 lie inside the file, so a truncated or foreign file is
+			 refused rather than read past its end later.
+*   @return  False if the file can't be mapped or isn't a pack.
+*/
+bool AssetPack::open(const std::string& path)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER file_size;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+	{
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	base = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	file_handle = file;
+	mapping_handle = mapping;
+	mapped_size = static_cast<size_t>(file_size.QuadPart);
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	void* view = MAP_FAILED;
+	if (fstat(file, &info) == 0 && info.st_size > 0)
+	{
+		view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	}
+
+	// the mapping keeps the file open by itself
+	::close(file);
+	if (view != MAP_FAILED)
+	{
+		base = static_cast<const unsigned char*>(view);
+		mapped_size = static_cast<size_t>(info.st_size);
+	}
+#endif
+
+	if (!base)
+	{
+		close();
+		return false;
+	}
+
+	const Header* head = header();
+	size_t table_end = sizeof(Header);
+	bool ok = mapped_size >= sizeof(Header) &&
+		!memcmp(head->magic, pack_magic, sizeof(pack_magic)) &&
+		head->version == version &&
+		head->slot_count > 0 && (head->slot_count & (head->slot_count - 1)) == 0 &&
+		head->entry_count < head->slot_count;
+
+	if (ok)
+	{
+		table_end += static_cast<size_t>(head->entry_count) * sizeof(PackEntry) +
+			static_cast<size_t>(head->slot_count) * sizeof(uint32_t);
+		ok = table_end <= mapped_size;
+	}
+
+	for (uint32_t i = 0; ok && i < head->entry_count; i++)
+	{
+		const PackEntry& entry = entries()[i];
+		ok = entry.offset % pixel_alignment == 0 &&
+			entry.offset <= mapped_size && entry.size <= mapped_size - entry.offset &&
+			entry.size == static_cast<uint64_t>(entry.width) * entry.height * 4 &&
+			table_end + entry.name_offset + entry.name_length <= mapped_size;
+	}
+
+	for (uint32_t i = 0; ok && i < head->slot_count; i++)
+	{
+		ok = slots()[i] <= head->entry_count;
+	}
+
+	if (!ok)
+	{
+		close();
+	}
+	return ok;
+}
+
+void AssetPack::close()
+{
+#ifdef _WIN32
+	if (base)
+	{
+		UnmapViewOfFile(base);
+	}
+	if (mapping_handle)
+	{
+		CloseHandle(static_cast<HANDLE>(mapping_handle));
+	}
+	if (file_handle)
+	{
+		CloseHandle(static_cast<HANDLE>(file_handle));
+	}
+#else
+	if (base)
+	{
+		munmap(const_cast<unsigned char*>(base), mapped_size);
+	}
+#endif
+
+	base = nullptr;
+	mapped_size = 0;
+	file_handle = nullptr;
+	mapping_handle = nullptr;
+}
+
+bool AssetPack::isOpen() const
+{
+	return base != nullptr;
+}
+
+/**
+*   @brief   Finds an image by path.
+*   @details Linear probing from the path's hash, the slots hold
+			 entry index + 1 and 0 marks the end of a run. The stored
+			 path is compared too, so a hash collision can't return
+			 the wrong image. A source file that still exists must
+			 match the stamp taken when it was packed.
+*   @return  True if the image is in the pack and up to date.
+*/
+bool AssetPack::find(const std::string& path, ImageView& image) const
+{
+	if (!base)
+	{
+		return false;
+	}
+
+	std::string key = normalisePath(path);
+	uint64_t key_hash = hash(key.data(), key.size());
+	uint32_t mask = header()->slot_count - 1;
+
+	for (uint32_t probe = 0; probe <= mask; probe++)
+	{
+		uint32_t slot = slots()[(key_hash + probe) & mask];
+		if (slot == 0)
+		{
+			return false;
+		}
+
+		const PackEntry& entry = entries()[slot - 1];
+		if (entry.path_hash == key_hash && entry.name_length == key.size() &&
+			!memcmp(names() + entry.name_offset, key.data(), key.size()))
+		{
+			uint64_t source_size;
+			int64_t source_time;
+			if (sourceStamp(path, source_size, source_time) &&
+				(source_size != entry.source_size || source_time != entry.source_time))
+			{
+				return false;
+			}
+
+			image.width = static_cast<int>(entry.width);
+			image.height = static_cast<int>(entry.height);
+			image.pixels = base + entry.offset;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool AssetPack::verify() const
+{
+	if (!base)
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header()->entry_count; i++)
+	{
+		const PackEntry& entry = entries()[i];
+		if (hash(base + entry.offset, static_cast<size_t>(entry.size)) != entry.content_hash)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int AssetPack::size() const
+{
+	return base ? static_cast<int>(header()->entry_count) : 0;
+}
+
+uint64_t AssetPack::hash(const void* data, size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t value = 14695981039346656037ull;
+	for (size_t i = 0; i < size; i++)
+	{
+		value ^= bytes[i];
+		value *= 1099511628211ull;
+	}
+	return value;
+}
+
+bool AssetPack::sourceStamp(const std::string& path, uint64_t& size, int64_t& time)
+{
+#ifdef _WIN32
+	struct _stat64 info;
+	if (_stat64(path.c_str(), &info) != 0)
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+#endif
+	{
+		return false;
+	}
+
+	size = static_cast<uint64_t>(info.st_size);
+	time = static_cast<int64_t>(info.st_mtime);
+	return true;
+}
+
+const AssetPack::Header* AssetPack::header() const
+{
+	return reinterpret_cast<const Header*>(base);
+}
+
+const PackEntry* AssetPack::entries() const
+{
+	return reinterpret_cast<const PackEntry*>(base + sizeof(Header));
+}
+
+const uint32_t* AssetPack::slots() const
+{
+	return reinterpret_cast<const uint32_t*>(entries() + header()->entry_count);
+}
+
+const char* AssetPack::names() const
+{
+	return reinterpret_cast<const char*>(slots() + header()->slot_count);
+}
+
+void AssetPackBuilder::add(const std::string& path, const ImageView& image)
+{
+	std::string name = normalisePath(path);
+	Item* item = nullptr;
+	for (Item& queued : items)
+	{
+		if (queued.name == name)
+		{
+			item = &queued;
+		}
+	}
+
+	if (!item)
+	{
+		items.push_back(Item());
+		item = &items.back();
+		item->name = name;
+	}
+
+	item->image.resize(image.width, image.height);
+	memcpy(item->image.pixels.data(), image.pixels, item->image.pixels.size());
+
+	if (!AssetPack::sourceStamp(path, item->source_size, item->source_time))
+	{
+		item->source_size = 0;
+		item->source_time = 0;
+	}
+}
+
+/**
+*   @brief   Writes the pack.
+*   @details The hash table is kept under half full so probes stay
+			 short. Padding between images is written as zeros.
+*   @return  False if the file can't be written.
+*/
+bool AssetPackBuilder::save(const std::string& path) const
+{
+	AssetPack::Header head;
+	memcpy(head.magic, pack_magic, sizeof(pack_magic));
+	head.version = AssetPack::version;
+	head.entry_count = static_cast<uint32_t>(items.size());
+	head.slot_count = 1;
+	while (head.slot_count < head.entry_count * 2 + 1)
+	{
+		head.slot_count *= 2;
+	}
+
+	std::vector<PackEntry> table(items.size());
+	std::vector<uint32_t> slots(head.slot_count, 0);
+	std::string names;
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		PackEntry& entry = table[i];
+		const Image& image = items[i].image;
+		entry.path_hash = AssetPack::hash(items[i].name.data(), items[i].name.size());
+		entry.content_hash = AssetPack::hash(image.pixels.data(), image.pixels.size());
+		entry.size = image.pixels.size();
+		entry.width = static_cast<uint32_t>(image.width);
+		entry.height = static_cast<uint32_t>(image.height);
+		entry.name_offset = static_cast<uint32_t>(names.size());
+		entry.name_length = static_cast<uint32_t>(items[i].name.size());
+		entry.source_size = items[i].source_size;
+		entry.source_time = items[i].source_time;
+		names += items[i].name;
+
+		uint32_t mask = head.slot_count - 1;
+		uint32_t slot = static_cast<uint32_t>(entry.path_hash) & mask;
+		while (slots[slot] != 0)
+		{
+			slot = (slot + 1) & mask;
+		}
+		slots[slot] = static_cast<uint32_t>(i + 1);
+	}
+
+	size_t offset = sizeof(head) + table.size() * sizeof(PackEntry) +
+		slots.size() * sizeof(uint32_t) + names.size();
+	for (PackEntry& entry : table)
+	{
+		offset = alignUp(offset, pixel_alignment);
+		entry.offset = offset;
+		offset += static_cast<size_t>(entry.size);
+	}
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	bool ok = fwrite(&head, sizeof(head), 1, file) == 1;
+	ok = ok && (table.empty() || fwrite(table.data(), sizeof(PackEntry), table.size(), file) == table.size());
+	ok = ok && fwrite(slots.data(), sizeof(uint32_t), slots.size(), file) == slots.size();
+	ok = ok && fwrite(names.data(), 1, names.size(), file) == names.size();
+
+	const unsigned char zeros[pixel_alignment] = {};
+	size_t written = sizeof(head) + table.size() * sizeof(PackEntry) +
+		slots.size() * sizeof(uint32_t) + names.size();
+	for (size_t i = 0; ok && i < items.size(); i++)
+	{
+		size_t padding = static_cast<size_t>(table[i].offset) - written;
+		ok = fwrite(zeros, 1, padding, file) == padding &&
+			fwrite(items[i].image.pixels.data(), 1, items[i].image.pixels.size(), file) ==
+			items[i].image.pixels.size();
+		written = static_cast<size_t>(table[i].offset + table[i].size);
+	}
+
+	return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "PngCodec.h"
+
+/**
+*  A read-only view of RGBA pixels owned by something else.
+*/
+struct ImageView
+{
+	int width = 0;
+	int height = 0;
+	const unsigned char* pixels = nullptr;   /**< Tightly packed rows, four bytes a pixel. */
+};
+
+/**
+*  One image stored in a pack, as laid out in the file.
+*/
+struct PackEntry
+{
+	uint64_t path_hash;      /**< FNV-1a of the normalised path. */
+	uint64_t content_hash;   /**< FNV-1a of the pixels. */
+	uint64_t offset;         /**< From the start of the file, a multiple of 16. */
+	uint64_t size;
+	uint32_t width;
+	uint32_t height;
+	uint32_t name_offset;    /**< The normalised path, in the name block. */
+	uint32_t name_length;
+	uint64_t source_size;    /**< Size of the PNG the image was decoded from, 0 if unknown. */
+	int64_t  source_time;    /**< Its modification time in seconds, 0 if unknown. */
+};
+
+/**
+*  A file of pre-decoded images, opened by mapping it into memory.
+*  Built offline with --pack-assets. The file starts with a header,
+*  then a table of entries, a hash table of entry indices keyed by
+*  path, the paths themselves, and finally the pixels of each image
+*  at 16 byte aligned offsets. Opening maps the file and checks the
+*  header, nothing is read or copied up front. Looking a path up is
+*  one hash probe, and the pixels handed back point straight into
+*  the mapping, so they are only paged in when first touched.
+*  Each entry records the size and modification time of the file it
+*  was decoded from, and is ignored once that file has changed.
+*/
+class AssetPack
+{
+public:
+	AssetPack() = default;
+	~AssetPack();
+
+	AssetPack(const AssetPack&) = delete;
+	AssetPack& operator=(const AssetPack&) = delete;
+
+	/**
+	*  Maps a pack file, closing any pack already open.
+	*  @return false if the file is missing or isn't a valid pack.
+	*/
+	bool open(const std::string& path);
+	void close();
+	bool isOpen() const;
+
+	/**
+	*  Looks an image up by path.
+	*  The file at the path is checked against the size and time it had
+	*  when packed, costing one stat. If the file is missing the packed
+	*  copy is used, so a pack can be shipped without its sources.
+	*  @param [out] image Points into the mapping, valid until close().
+	*  @return false if the pack doesn't hold the path, or the file has
+	*  changed since it was packed.
+	*/
+	bool find(const std::string& path, ImageView& image) const;
+
+	/**
+	*  Rehashes every image and compares it with the table.
+	*  This touches every page of the file, so it's meant for tools
+	*  rather than startup.
+	*  @return false if any image has been corrupted.
+	*/
+	bool verify() const;
+
+	int size() const;
+
+	/**
+	*  Hashes bytes with 64 bit FNV-1a.
+	*/
+	static uint64_t hash(const void* data, size_t size);
+
+	/**
+	*  Reads the size and modification time of a file.
+	*  @return false if the file doesn't exist.
+	*/
+	static bool sourceStamp(const std::string& path, uint64_t& size, int64_t& time);
+
+private:
+	struct Header
+	{
+		char     magic[4];
+		uint32_t version;
+		uint32_t entry_count;
+		uint32_t slot_count;     /**< Hash table size, a power of two. */
+	};
+
+	static const uint32_t version = 2;
+
+	const Header*    header() const;
+	const PackEntry* entries() const;
+	const uint32_t*  slots() const;
+	const char*      names() const;
+
+	const unsigned char* base = nullptr;
+	size_t mapped_size = 0;
+	void*  file_handle = nullptr;       /**< Platform handles, see AssetPack.cpp. */
+	void*  mapping_handle = nullptr;
+
+	friend class AssetPackBuilder;
+};
+
+/**
+*  Writes an AssetPack.
+*/
+class AssetPackBuilder
+{
+public:
+	/**
+	*  Queues a copy of an image. Later images replace earlier ones of
+	*  the same path. The file at the path is stamped now, so it should
+	*  be the one the image was just decoded from.
+	*/
+	void add(const std::string& path, const ImageView& image);
+
+	/**
+	*  Lays out and writes the pack.
+	*/
+	bool save(const std::string& path) const;
+
+private:
+	struct Item
+	{
+		std::string name;   /**< The normalised path. */
+		Image image;
+		uint64_t source_size = 0;
+		int64_t  source_time = 0;
+	};
+
+	std::vector<Item> items;
+};
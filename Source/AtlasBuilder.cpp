@@ -0,0 +1,278 @@
+#include <string.h>
+#include <algorithm>
+
+#include "AtlasBuilder.h"
+
+SkylinePacker::SkylinePacker(int width, int height)
+	: page_width(width), page_height(height)
+{
+	Segment floor = { 0, 0, width };
+	skyline.push_back(floor);
+}
+
+int SkylinePacker::fit(size_t index, int width, int height) const
+{
+	int x = skyline[index].x;
+	if (x + width > page_width)
+	{
+		return -1;
+	}
+
+	// the rectangle rests on the highest segment it spans
+	int y = 0;
+	int left = width;
+	for (size_t i = index; left > 0; i++)
+	{
+		y = std::max(y, skyline[i].y);
+		if (y + height > page_height)
+		{
+			return -1;
+		}
+		left -= skyline[i].width;
+	}
+
+	return y;
+}
+
+/**
+*   @brief   Places a rectangle on the skyline.
+*   @details Every segment start is tried and the one leaving the
+			 lowest top wins, ties going to the narrower segment so
+			 wide gaps are kept for wide rectangles. The new top then
+			 replaces the stretch of skyline under it, and neighbours
+			 at the same height are merged.
+*   @return  False if the rectangle doesn't fit anywhere.
+*/
+bool SkylinePacker::insert(int width, int height, int& x, int& y)
+{
+	if (width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	size_t best = skyline.size();
+	int best_bottom = page_height + 1;
+	int best_width = page_width + 1;
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		int top = fit(i, width, height);
+		if (top < 0)
+		{
+			continue;
+		}
+
+		int bottom = top + height;
+		if (bottom < best_bottom || (bottom == best_bottom && skyline[i].width < best_width))
+		{
+			best = i;
+			best_bottom = bottom;
+			best_width = skyline[i].width;
+		}
+	}
+
+	if (best == skyline.size())
+	{
+		return false;
+	}
+
+	x = skyline[best].x;
+	y = best_bottom - height;
+
+	Segment placed = { x, best_bottom, width };
+	skyline.insert(skyline.begin() + best, placed);
+
+	// trim the segments now underneath the new one
+	size_t next = best + 1;
+	while (next < skyline.size())
+	{
+		int covered = x + width - skyline[next].x;
+		if (covered <= 0)
+		{
+			break;
+		}
+
+		if (covered >= skyline[next].width)
+		{
+			skyline.erase(skyline.begin() + next);
+			continue;
+		}
+
+		skyline[next].x += covered;
+		skyline[next].width -= covered;
+		break;
+	}
+
+	for (size_t i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	used_area += static_cast<long>(width) * height;
+	return true;
+}
+
+float SkylinePacker::occupancy() const
+{
+	return static_cast<float>(used_area) / (static_cast<float>(page_width) * page_height);
+}
+
+AtlasBuilder::AtlasBuilder(int page_size, int padding)
+	: page_size(page_size), padding(padding > 0 ? padding : 0)
+{
+}
+
+void AtlasBuilder::add(const std::string& name, const Image& image)
+{
+	Entry entry;
+	entry.name = name;
+	entry.image = image;
+	entries.push_back(entry);
+}
+
+/**
+*   @brief   Packs the queued images onto pages.
+*   @details Each image tries every open page before a new one is
+			 started. Afterwards each page is cut down to the
+			 smallest power of two height that holds what was packed
+			 on it.
+*   @return  False if an image is too big for an empty page.
+*/
+bool AtlasBuilder::build(const std::string& page_name)
+{
+	page_images.clear();
+	result.clear();
+
+	std::vector<size_t> order(entries.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+
+	std::sort(order.begin(), order.end(), [this](size_t a, size_t b)
+	{
+		const Image& first = entries[a].image;
+		const Image& second = entries[b].image;
+		if (first.height != second.height)
+		{
+			return first.height > second.height;
+		}
+		if (first.width != second.width)
+		{
+			return first.width > second.width;
+		}
+		return entries[a].name < entries[b].name;
+	});
+
+	std::vector<SkylinePacker> packers;
+	std::vector<int> used_height;
+	for (size_t index : order)
+	{
+		const Entry& entry = entries[index];
+		int width = entry.image.width + padding * 2;
+		int height = entry.image.height + padding * 2;
+
+		int x = 0;
+		int y = 0;
+		size_t page = 0;
+		while (page < packers.size() && !packers[page].insert(width, height, x, y))
+		{
+			page++;
+		}
+
+		if (page == packers.size())
+		{
+			packers.emplace_back(page_size, page_size);
+			used_height.push_back(0);
+			page_images.emplace_back();
+			page_images.back().resize(page_size, page_size);
+			result.addPage(page_name + "_" + std::to_string(page) + ".png");
+
+			if (!packers.back().insert(width, height, x, y))
+			{
+				page_images.clear();
+				result.clear();
+				return false;
+			}
+		}
+
+		blit(entry.image, page_images[page], x + padding, y + padding);
+		used_height[page] = std::max(used_height[page], y + height);
+
+		AtlasRegion region;
+		region.page = static_cast<int>(page);
+		region.x = x + padding;
+		region.y = y + padding;
+		region.width = entry.image.width;
+		region.height = entry.image.height;
+		result.addRegion(entry.name, region);
+	}
+
+	for (size_t page = 0; page < page_images.size(); page++)
+	{
+		int height = 1;
+		while (height < used_height[page])
+		{
+			height *= 2;
+		}
+
+		// rows are packed top to bottom, so cutting the end off is enough
+		page_images[page].height = height;
+		page_images[page].pixels.resize(static_cast<size_t>(page_size) * height * 4);
+	}
+
+	return true;
+}
+
+bool AtlasBuilder::save(const std::string& atlas_path) const
+{
+	size_t separator = atlas_path.find_last_of("/\\");
+	std::string directory = separator == std::string::npos ? "" : atlas_path.substr(0, separator + 1);
+
+	for (int page = 0; page < result.pageCount(); page++)
+	{
+		std::string page_path = result.pagePath(page);
+		if (!savePng(directory + page_path, page_images[page]))
+		{
+			return false;
+		}
+	}
+
+	return result.save(atlas_path);
+}
+
+const std::vector<Image>& AtlasBuilder::pages() const
+{
+	return page_images;
+}
+
+const TextureAtlas& AtlasBuilder::atlas() const
+{
+	return result;
+}
+
+/**
+*   @brief   Copies an image onto a page with an extruded border.
+*   @details The padding around the image is filled by clamping to
+			 the image's edge, so the corners take the corner pixels.
+*   @return  void
+*/
+void AtlasBuilder::blit(const Image& source, Image& page, int x, int y) const
+{
+	for (int row = -padding; row < source.height + padding; row++)
+	{
+		int source_row = std::min(std::max(row, 0), source.height - 1);
+		for (int column = -padding; column < source.width + padding; column++)
+		{
+			int source_column = std::min(std::max(column, 0), source.width - 1);
+			memcpy(page.pixel(x + column, y + row), source.pixel(source_column, source_row), 4);
+		}
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "PngCodec.h"
+#include "TextureAtlas.h"
+
+/**
+*  Packs rectangles into a fixed size page with the skyline method.
+*  The packed area is tracked as the outline of its top edge, a list
+*  of horizontal segments. Each rectangle goes where its top ends up
+*  lowest, bottom-left first, and then becomes part of the outline.
+*  Cheap to run and wastes little space when the rectangles are
+*  added tallest first.
+*/
+class SkylinePacker
+{
+public:
+	SkylinePacker(int width, int height);
+
+	/**
+	*  Finds a place for a rectangle and reserves it.
+	*  @param [out] x The left of the place found.
+	*  @param [out] y The top of the place found.
+	*  @return false if the rectangle no longer fits.
+	*/
+	bool insert(int width, int height, int& x, int& y);
+
+	/**
+	*  @return the fraction of the page that has been reserved.
+	*/
+	float occupancy() const;
+
+private:
+	struct Segment
+	{
+		int x;
+		int y;        /**< The lowest free row above this stretch. */
+		int width;
+	};
+
+	/**
+	*  @return the top a rectangle would sit at if its left edge is at
+	*  the start of a segment, or -1 if it doesn't fit there.
+	*/
+	int fit(size_t index, int width, int height) const;
+
+	std::vector<Segment> skyline;
+	int  page_width;
+	int  page_height;
+	long used_area = 0;
+};
+
+/**
+*  Builds texture atlases from separate images.
+*  Images are packed tallest first onto as many pages as it takes.
+*  Each one is surrounded by a border copied from its own edge
+*  pixels, so filtering at the edge of a region never samples a
+*  neighbouring sprite.
+*/
+class AtlasBuilder
+{
+public:
+	/**
+	*  @param [in] page_size The width and height of each page.
+	*  @param [in] padding The border left around each image.
+	*/
+	explicit AtlasBuilder(int page_size = 512, int padding = 2);
+
+	/**
+	*  Queues an image to be packed.
+	*  @param [in] name The name the sprite is looked up by.
+	*/
+	void add(const std::string& name, const Image& image);
+
+	/**
+	*  Packs every queued image.
+	*  @param [in] page_name Pages are called page_name_0.png and so on.
+	*  @return false if an image is too big for a page.
+	*/
+	bool build(const std::string& page_name);
+
+	/**
+	*  Writes the pages and the atlas file.
+	*  @param [in] atlas_path The atlas file, pages go next to it.
+	*/
+	bool save(const std::string& atlas_path) const;
+
+	const std::vector<Image>& pages() const;
+	const TextureAtlas& atlas() const;
+
+private:
+	struct Entry
+	{
+		std::string name;
+		Image image;
+	};
+
+	void blit(const Image& source, Image& page, int x, int y) const;
+
+	int page_size;
+	int padding;
+	std::vector<Entry> entries;
+	std::vector<Image> page_images;
+	TextureAtlas result;
+};
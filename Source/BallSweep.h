@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include "BrickField.h"
+#include "Rect.h"
+#include "Scalar.h"
+#include "Shapes.h"
+#include "Sweep.h"
+
+/**
+*  Sweeps a ball's box against the sides of the play area.
+*  The side walls are tested first and win a tie with the ceiling or
+*  floor. Shared by Simulation and StressMode so the two can't drift.
+*  @param [in] ball The ball's box at the start of the move.
+*  @param [in] dx The displacement on the x axis.
+*  @param [in] dy The displacement on the y axis.
+*  @param [in] width The width of the play area.
+*  @param [in] height The height of the play area.
+*  @param [in] solid_floor Whether the ball bounces off the bottom edge
+*  rather than falling through it.
+*  @param [out] impact The earliest impact, time 1 if there is none.
+*  @return true if a side is struck during the move.
+*/
+inline bool sweepBallBounds(const rect& ball, real dx, real dy, real width, real height,
+	bool solid_floor, sweep_result& impact)
+{
+	bool found = false;
+	impact = sweep_result();
+
+	if (dx != 0)
+	{
+		real gap = dx < 0 ? -ball.x : width - (ball.x + ball.length);
+		real t = gap / dx;
+		t = t < 0 ? 0 : t;
+		if (t <= impact.time)
+		{
+			impact.time = t;
+			impact.normal_x = dx < 0 ? 1 : -1;
+			impact.normal_y = 0;
+			found = true;
+		}
+	}
+
+	if (dy < 0 || (dy > 0 && solid_floor))
+	{
+		real gap = dy < 0 ? -ball.y : height - (ball.y + ball.height);
+		real t = gap / dy;
+		t = t < 0 ? 0 : t;
+		if (t <= impact.time && (!found || t < impact.time))
+		{
+			impact.time = t;
+			impact.normal_x = 0;
+			impact.normal_y = dy < 0 ? 1 : -1;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+/**
+*  Sweeps a ball against the live bricks among some candidates.
+*  A brick only replaces an earlier impact if it is struck sooner, and
+*  ties between bricks go to the lowest index, so the result doesn't
+*  depend on the order the broadphase lists them in.
+*  @param [in] ball The ball, already in its collision shape.
+*  @param [in] candidates Bricks near the ball's path.
+*  @param [in] found Whether impact already holds an impact.
+*  @param [in,out] impact The earliest impact so far.
+*  @param [out] block The brick struck, left alone if none is sooner.
+*  @return true if impact holds an impact.
+*/
+template <typename BlockShape, typename BallShape>
+bool sweepBallBlocks(const BallShape& ball, real dx, real dy, const BrickField& blocks,
+	const std::vector<int>& candidates, bool found, sweep_result& impact, int& block)
+{
+	sweep_result hit;
+	for (int i : candidates)
+	{
+		if (!blocks.isAlive(i) ||
+			!sweepShape(ball, dx, dy, shapeFromBox<BlockShape>(blocks.bounds(i)), hit))
+		{
+			continue;
+		}
+
+		if (!found || hit.time < impact.time ||
+			(hit.time == impact.time && block >= 0 && i < block))
+		{
+			impact = hit;
+			block = i;
+			found = true;
+		}
+	}
+
+	return found;
+}
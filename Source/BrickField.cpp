@@ -0,0 +1,130 @@
+#include "BrickField.h"
+
+/**
+*   @brief   Counts the set bits in a word.
+*   @details GCC and Clang use their builtin, which only becomes
+			 the POPCNT instruction when the target has it. Other
+			 compilers count with shifts and masks, as MSVC's
+			 __popcnt would fault on a CPU without POPCNT. Either way
+			 a count covers 64 bricks, so large levels stay cheap.
+*   @return  The number of bits set.
+*/
+static int popcount(uint64_t bits)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(bits);
+#else
+	bits -= (bits >> 1) & 0x5555555555555555ull;
+	bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+	bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0full;
+	return static_cast<int>((bits * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+void BrickField::resize(int new_count)
+{
+	count = new_count > 0 ? new_count : 0;
+	x.assign(count, 0);
+	y.assign(count, 0);
+	width.assign(count, 0);
+	height.assign(count, 0);
+	alive.assign((count + 63) / 64, ~uint64_t(0));
+
+	// clear the bits past the end so the popcount stays exact
+	if (count % 64)
+	{
+		alive.back() = (uint64_t(1) << (count % 64)) - 1;
+	}
+}
+
+int BrickField::size() const
+{
+	return count;
+}
+
+int BrickField::aliveCount() const
+{
+	int total = 0;
+	for (uint64_t bits : alive)
+	{
+		total += popcount(bits);
+	}
+
+	return total;
+}
+
+bool BrickField::isAlive(int i) const
+{
+	return (alive[i >> 6] >> (i & 63)) & 1;
+}
+
+void BrickField::setAlive(int i, bool is_alive)
+{
+	uint64_t bit = uint64_t(1) << (i & 63);
+	if (is_alive)
+	{
+		alive[i >> 6] |= bit;
+	}
+	else
+	{
+		alive[i >> 6] &= ~bit;
+	}
+}
+
+void BrickField::setPosition(int i, real new_x, real new_y)
+{
+	x[i] = new_x;
+	y[i] = new_y;
+}
+
+void BrickField::setSize(int i, real new_width, real new_height)
+{
+	width[i] = new_width;
+	height[i] = new_height;
+}
+
+rect BrickField::bounds(int i) const
+{
+	rect bounding_box;
+	bounding_box.x = x[i];
+	bounding_box.y = y[i];
+	bounding_box.length = width[i];
+	bounding_box.height = height[i];
+	return bounding_box;
+}
+
+rect_batch BrickField::batch() const
+{
+	rect_batch packed;
+	packed.x = x.data();
+	packed.y = y.data();
+	packed.length = width.data();
+	packed.height = height.data();
+	packed.count = count;
+	return packed;
+}
+
+const real* BrickField::xs() const
+{
+	return x.data();
+}
+
+const real* BrickField::ys() const
+{
+	return y.data();
+}
+
+const real* BrickField::widths() const
+{
+	return width.data();
+}
+
+const real* BrickField::heights() const
+{
+	return height.data();
+}
+
+const uint64_t* BrickField::aliveBits() const
+{
+	return alive.data();
+}
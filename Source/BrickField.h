@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "Rect.h"
+#include "RectBatch.h"
+
+/**
+*  Storage for every block in a level.
+*  Positions and sizes are kept in separate contiguous arrays and
+*  whether each block is still standing is kept in a bitset, so a
+*  pass over the field only touches the data it needs. The number
+*  of blocks left is a popcount over the bitset.
+*/
+class BrickField
+{
+public:
+	/**
+	*  Resizes the field. Every block is alive and zero sized.
+	*  @param [in] count The number of blocks in the level.
+	*/
+	void resize(int count);
+
+	int  size() const;
+	int  aliveCount() const;
+
+	bool isAlive(int i) const;
+	void setAlive(int i, bool alive);
+
+	void setPosition(int i, real x, real y);
+	void setSize(int i, real width, real height);
+
+	/**
+	*  Builds a rectangle from a block's position and size.
+	*  @param [in] i The block index.
+	*  @return the block's bounds.
+	*/
+	rect bounds(int i) const;
+
+	/**
+	*  Views every block as a batch for the overlap kernels.
+	*  @return the packed bounds of all blocks, alive or not.
+	*/
+	rect_batch batch() const;
+
+	const real* xs() const;
+	const real* ys() const;
+	const real* widths() const;
+	const real* heights() const;
+	const uint64_t* aliveBits() const;
+
+private:
+	std::vector<real>     x;
+	std::vector<real>     y;
+	std::vector<real>     width;
+	std::vector<real>     height;
+	std::vector<uint64_t> alive;
+	int count = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include "Rect.h"
+
+/**
+*  Interface for broadphase collision structures.
+*  A broadphase stores the bounds of many objects by id and can
+*  quickly return the ids that might overlap an area. Anything it
+*  returns still needs an exact narrowphase test, but everything it
+*  leaves out is guaranteed not to touch the area.
+*/
+class Broadphase
+{
+public:
+	virtual ~Broadphase() = default;
+
+	/**
+	*  Removes every object.
+	*/
+	virtual void clear() = 0;
+
+	/**
+	*  Adds an object.
+	*  @param [in] id A non-negative id, unique within the broadphase.
+	*  @param [in] bounds The area the object covers.
+	*/
+	virtual void insert(int id, const rect& bounds) = 0;
+
+	/**
+	*  Removes an object that was previously inserted.
+	*  @param [in] id The id it was inserted with.
+	*/
+	virtual void remove(int id) = 0;
+
+	/**
+	*  Collects the ids of objects that may overlap an area.
+	*  Each id is reported at most once per query.
+	*  @param [in] area The area to search.
+	*  @param [out] results Cleared and filled with candidate ids.
+	*/
+	virtual void query(const rect& area, std::vector<int>& results) const = 0;
+};
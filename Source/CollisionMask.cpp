@@ -0,0 +1,139 @@
+#include "CollisionMask.h"
+
+void CollisionMask::build(const unsigned char* pixels, int width, int height,
+	int channels, unsigned char threshold)
+{
+	if (channels != 2 && channels != 4)
+	{
+		fill(width, height);
+		return;
+	}
+
+	mask_width = width;
+	mask_height = height;
+	words_per_row = (width + 63) / 64;
+	bits.assign(static_cast<size_t>(words_per_row) * height, 0);
+
+	for (int y = 0; y < height; y++)
+	{
+		const unsigned char* alpha = pixels + static_cast<size_t>(y) * width * channels + channels - 1;
+		uint64_t* row = bits.data() + static_cast<size_t>(y) * words_per_row;
+
+		for (int x = 0; x < width; x++, alpha += channels)
+		{
+			if (*alpha >= threshold)
+			{
+				row[x >> 6] |= uint64_t(1) << (x & 63);
+			}
+		}
+	}
+}
+
+void CollisionMask::fill(int width, int height)
+{
+	mask_width = width;
+	mask_height = height;
+	words_per_row = (width + 63) / 64;
+	bits.assign(static_cast<size_t>(words_per_row) * height, ~uint64_t(0));
+
+	// keep the padding past the last column empty so bitsAt can
+	// read across the end of a row without seeing solid pixels
+	int tail = width & 63;
+	if (tail)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			bits[static_cast<size_t>(y) * words_per_row + words_per_row - 1] =
+				(uint64_t(1) << tail) - 1;
+		}
+	}
+}
+
+int CollisionMask::width() const
+{
+	return mask_width;
+}
+
+int CollisionMask::height() const
+{
+	return mask_height;
+}
+
+bool CollisionMask::empty() const
+{
+	return bits.empty();
+}
+
+bool CollisionMask::isSolid(int x, int y) const
+{
+	if (x < 0 || y < 0 || x >= mask_width || y >= mask_height)
+	{
+		return false;
+	}
+
+	return (bits[static_cast<size_t>(y) * words_per_row + (x >> 6)] >> (x & 63)) & 1;
+}
+
+uint64_t CollisionMask::bitsAt(int y, int x) const
+{
+	if (y < 0 || y >= mask_height || x >= mask_width || x <= -64)
+	{
+		return 0;
+	}
+
+	const uint64_t* row = bits.data() + static_cast<size_t>(y) * words_per_row;
+	if (x < 0)
+	{
+		return row[0] << -x;
+	}
+
+	int word = x >> 6;
+	int shift = x & 63;
+	uint64_t value = row[word] >> shift;
+	if (shift && word + 1 < words_per_row)
+	{
+		value |= row[word + 1] << (64 - shift);
+	}
+
+	return value;
+}
+
+/**
+*   @brief   Tests two masks for a shared solid pixel.
+*   @details Walks the rows both masks cover. For each one, 64 pixels
+			 of each mask are lined up and ANDed, so a row of a typical
+			 sprite is a single comparison.
+*   @return  True if a pixel is solid in both masks.
+*/
+bool masksOverlap(const CollisionMask& a, int ax, int ay,
+	const CollisionMask& b, int bx, int by)
+{
+	int left = ax > bx ? ax : bx;
+	int top = ay > by ? ay : by;
+	int right = ax + a.width() < bx + b.width() ? ax + a.width() : bx + b.width();
+	int bottom = ay + a.height() < by + b.height() ? ay + a.height() : by + b.height();
+	if (left >= right || top >= bottom)
+	{
+		return false;
+	}
+
+	for (int y = top; y < bottom; y++)
+	{
+		for (int x = left; x < right; x += 64)
+		{
+			uint64_t shared = a.bitsAt(y - ay, x - ax) & b.bitsAt(y - by, x - bx);
+			int span = right - x;
+			if (span < 64)
+			{
+				shared &= (uint64_t(1) << span) - 1;
+			}
+
+			if (shared)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+*  A 1-bit solidity mask baked from a texture's alpha channel.
+*  Each row is packed into 64-bit words, lowest bit first, so two
+*  masks can be tested against each other a word at a time instead
+*  of pixel by pixel. Masks are built once when a texture is loaded
+*  and are only consulted after a bounding box test has passed.
+*/
+class CollisionMask
+{
+public:
+	/**
+	*  Builds the mask from raw pixel data.
+	*  Formats with no alpha channel produce a fully solid mask.
+	*  @param [in] pixels Tightly packed rows of pixel data.
+	*  @param [in] width The width of the image in pixels.
+	*  @param [in] height The height of the image in pixels.
+	*  @param [in] channels Bytes per pixel, 1 to 4. The alpha is the
+	*  last channel when there are 2 or 4.
+	*  @param [in] threshold Alpha values at or above this are solid.
+	*/
+	void build(const unsigned char* pixels, int width, int height,
+		int channels, unsigned char threshold = 128);
+
+	/**
+	*  Makes a fully solid mask of the given size.
+	*/
+	void fill(int width, int height);
+
+	int  width() const;
+	int  height() const;
+	bool empty() const;
+	bool isSolid(int x, int y) const;
+
+	/**
+	*  Reads 64 pixels of a row starting at any column.
+	*  Pixels outside the mask read as empty.
+	*/
+	uint64_t bitsAt(int y, int x) const;
+
+private:
+	int mask_width = 0;
+	int mask_height = 0;
+	int words_per_row = 0;
+	std::vector<uint64_t> bits;
+};
+
+/**
+*  Tests two masks for a shared solid pixel.
+*  Only the rows and columns where the masks overlap are visited,
+*  and each row is compared 64 pixels at a time.
+*  @param [in] a The first mask.
+*  @param [in] ax, ay Where the first mask's top left pixel is.
+*  @param [in] b The second mask.
+*  @param [in] bx, by Where the second mask's top left pixel is.
+*  @return true if any pixel is solid in both.
+*/
+bool masksOverlap(const CollisionMask& a, int ax, int ay,
+	const CollisionMask& b, int bx, int by);
@@ -0,0 +1,52 @@
+#pragma once
+#include "Pool.h"
+#include "SpriteComponent.h"
+
+/**
+*  Components the game gives its entities.
+*  Every entity that is drawn has a Transform and a Renderable, and
+*  one link saying which part of the simulation it mirrors. Entities
+*  of one kind share a sprite, which is moved onto each in turn just
+*  before it is drawn.
+*  @see EntityStore
+*/
+
+/**
+*  Draws an entity with a sprite from the game's sprite pool.
+*/
+struct Renderable
+{
+	Pool<SpriteComponent>::Handle sprite;
+	bool visible = true;
+};
+
+/**
+*  Marks the paddle.
+*/
+struct PaddleLink
+{
+};
+
+/**
+*  Mirrors SimState::balls[index].
+*/
+struct BallLink
+{
+	int index = 0;
+};
+
+/**
+*  Mirrors the block at index in SimState::blocks.
+*/
+struct BlockLink
+{
+	int index = 0;
+};
+
+/**
+*  Mirrors SimState::gems[index].
+*/
+struct GemLink
+{
+	int index = 0;
+};
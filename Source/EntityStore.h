@@ -0,0 +1,563 @@
+#pragma once
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+*  Refers to an entity in an EntityStore.
+*  Carries a generation like a PoolHandle, so a handle to a destroyed
+*  entity is never mistaken for whatever reuses its slot.
+*/
+struct Entity
+{
+	uint32_t index = 0;
+	uint32_t generation = 0;
+
+	bool operator==(const Entity& rhs) const
+	{
+		return index == rhs.index && generation == rhs.generation;
+	}
+
+	bool operator!=(const Entity& rhs) const { return !(*this == rhs); }
+};
+
+namespace entity_detail
+{
+	/**
+	*  Archetype masks have one bit per component type.
+	*/
+	const uint32_t max_components = 64;
+
+	inline uint32_t nextComponentId()
+	{
+		static uint32_t next = 0;
+		assert(next < max_components && "EntityStore masks hold at most 64 component types");
+		return next++;
+	}
+
+	template <typename T>
+	void moveTo(void* dst, void* src)
+	{
+		T* from = static_cast<T*>(src);
+		new (dst) T(std::move(*from));
+		from->~T();
+	}
+
+	template <typename T>
+	void destroyAt(void* p)
+	{
+		static_cast<T*>(p)->~T();
+	}
+}
+
+/**
+*  A small number identifying a component type, handed out on first use.
+*/
+template <typename T>
+uint32_t componentId()
+{
+	static const uint32_t id = entity_detail::nextComponentId();
+	return id;
+}
+
+/**
+*  Entities grouped by the set of components they have.
+*  Every distinct set of components is an archetype, and each
+*  archetype keeps one contiguous array per component type, with one
+*  row per entity. Iterating every entity with some components is a
+*  walk down the matching archetypes' arrays, with no lookups per
+*  entity and no gaps. Adding or removing a component moves the
+*  entity's row to another archetype, so those are the slow
+*  operations. Any movable type can be a component, up to 64 types.
+*/
+class EntityStore
+{
+public:
+	EntityStore() = default;
+	EntityStore(const EntityStore&) = delete;
+	EntityStore& operator=(const EntityStore&) = delete;
+
+	/**
+	*  Makes an entity with an initial set of components.
+	*  Each component type may only appear once.
+	*  @return a handle to the new entity.
+	*/
+	template <typename... Cs>
+	Entity create(Cs&&... components)
+	{
+		Archetype& archetype = archetypeFor<typename std::decay<Cs>::type...>();
+		Entity entity = allocate();
+		place(entity, archetype);
+
+		int expand[] = { 0, (construct(archetype, std::forward<Cs>(components)), 0)... };
+		(void)expand;
+		return entity;
+	}
+
+	/**
+	*  Destroys an entity and all its components.
+	*  Stale handles are ignored.
+	*/
+	void destroy(Entity entity)
+	{
+		if (!isAlive(entity))
+		{
+			return;
+		}
+
+		Record& record = records[entity.index];
+		Archetype& archetype = *archetypes[record.archetype];
+		for (Column& column : archetype.columns)
+		{
+			column.destroy(column.at(record.row));
+			column.eraseMoved(record.row);
+		}
+		unplace(archetype, record.row);
+
+		record.generation = record.generation + 1 ? record.generation + 1 : 1;
+		record.archetype = -1;
+		free_records.push_back(entity.index);
+		live_count--;
+	}
+
+	bool isAlive(Entity entity) const
+	{
+		return entity.index < records.size() &&
+			records[entity.index].archetype >= 0 &&
+			records[entity.index].generation == entity.generation;
+	}
+
+	/**
+	*  Looks up one of an entity's components.
+	*  @return the component, or nullptr if the entity is gone or
+	*  doesn't have one.
+	*/
+	template <typename C>
+	C* get(Entity entity)
+	{
+		if (!isAlive(entity))
+		{
+			return nullptr;
+		}
+
+		const Record& record = records[entity.index];
+		Column* column = archetypes[record.archetype]->find(componentId<C>());
+		return column ? static_cast<C*>(column->at(record.row)) : nullptr;
+	}
+
+	/**
+	*  Gives an entity a component, replacing any it already has.
+	*  @return the stored component, or nullptr if the entity is gone.
+	*/
+	template <typename C>
+	typename std::decay<C>::type* add(Entity entity, C&& component)
+	{
+		typedef typename std::decay<C>::type T;
+		if (!isAlive(entity))
+		{
+			return nullptr;
+		}
+
+		if (T* existing = get<T>(entity))
+		{
+			*existing = std::forward<C>(component);
+			return existing;
+		}
+
+		Record& record = records[entity.index];
+		Archetype& from = *archetypes[record.archetype];
+		Archetype& to = archetypeWith(from, Column::make<T>());
+		move(entity, from, to);
+		construct(to, std::forward<C>(component));
+		return get<T>(entity);
+	}
+
+	/**
+	*  Takes a component away from an entity, if it has one.
+	*/
+	template <typename C>
+	void remove(Entity entity)
+	{
+		if (!get<C>(entity))
+		{
+			return;
+		}
+
+		Record& record = records[entity.index];
+		Archetype& from = *archetypes[record.archetype];
+		Archetype& to = archetypeWithout(from, componentId<C>());
+		move(entity, from, to);
+	}
+
+	/**
+	*  Calls f(entity, components...) for every entity that has all of
+	*  the listed components, archetype by archetype in the order the
+	*  archetypes were first used, and row by row within each. Entities
+	*  must not be created or destroyed, or have components added or
+	*  removed, from inside f.
+	*/
+	template <typename... Cs, typename F>
+	void each(F&& f)
+	{
+		uint64_t wanted = maskOf<Cs...>();
+		for (auto& archetype : archetypes)
+		{
+			if ((archetype->mask & wanted) == wanted && !archetype->entities.empty())
+			{
+				eachRow(*archetype, f, std::make_tuple(
+					static_cast<Cs*>(archetype->find(componentId<Cs>())->at(0))...),
+					std::index_sequence_for<Cs...>());
+			}
+		}
+	}
+
+	/**
+	*  The number of entities that have all of the listed components.
+	*/
+	template <typename... Cs>
+	int count() const
+	{
+		uint64_t wanted = maskOf<Cs...>();
+		size_t total = 0;
+		for (const auto& archetype : archetypes)
+		{
+			if ((archetype->mask & wanted) == wanted)
+			{
+				total += archetype->entities.size();
+			}
+		}
+
+		return static_cast<int>(total);
+	}
+
+	int size() const { return live_count; }
+
+private:
+	/**
+	*  One component array, typed only by the functions that move and
+	*  destroy its elements.
+	*/
+	class Column
+	{
+	public:
+		template <typename T>
+		static Column make()
+		{
+			static_assert(alignof(T) <= alignof(max_align_t), "over-aligned components aren't supported");
+			Column column;
+			column.id = componentId<T>();
+			column.element_size = sizeof(T);
+			column.move_to = &entity_detail::moveTo<T>;
+			column.destroy = &entity_detail::destroyAt<T>;
+			return column;
+		}
+
+		/**
+		*  An empty column of the same type.
+		*/
+		Column emptyCopy() const
+		{
+			Column column;
+			column.id = id;
+			column.element_size = element_size;
+			column.move_to = move_to;
+			column.destroy = destroy;
+			return column;
+		}
+
+		Column() = default;
+		Column(Column&& rhs) { *this = std::move(rhs); }
+
+		Column& operator=(Column&& rhs)
+		{
+			std::swap(id, rhs.id);
+			std::swap(element_size, rhs.element_size);
+			std::swap(move_to, rhs.move_to);
+			std::swap(destroy, rhs.destroy);
+			std::swap(data, rhs.data);
+			std::swap(count, rhs.count);
+			std::swap(capacity, rhs.capacity);
+			return *this;
+		}
+
+		~Column()
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				destroy(at(i));
+			}
+			::operator delete(data);
+		}
+
+		void* at(size_t row) { return data + row * element_size; }
+
+		/**
+		*  Adds a row at the end and returns it, unconstructed.
+		*/
+		void* push()
+		{
+			if (count == capacity)
+			{
+				size_t grown = capacity ? capacity * 2 : 16;
+				unsigned char* bigger = static_cast<unsigned char*>(::operator new(grown * element_size));
+				for (size_t i = 0; i < count; i++)
+				{
+					move_to(bigger + i * element_size, at(i));
+				}
+
+				::operator delete(data);
+				data = bigger;
+				capacity = grown;
+			}
+
+			return at(count++);
+		}
+
+		/**
+		*  Drops a row whose element has already been destroyed or moved
+		*  out, filling the gap with the last row.
+		*/
+		void eraseMoved(size_t row)
+		{
+			if (row != count - 1)
+			{
+				move_to(at(row), at(count - 1));
+			}
+			count--;
+		}
+
+		uint32_t id = 0;
+		size_t   element_size = 0;
+		void (*move_to)(void* dst, void* src) = nullptr;
+		void (*destroy)(void* p) = nullptr;
+
+	private:
+		unsigned char* data = nullptr;
+		size_t count = 0;
+		size_t capacity = 0;
+	};
+
+	struct Archetype
+	{
+		uint64_t mask = 0;
+		std::vector<Column> columns;   /**< One per component, sorted by id. */
+		std::vector<Entity> entities;  /**< The entity in each row. */
+
+		Column* find(uint32_t id)
+		{
+			for (Column& column : columns)
+			{
+				if (column.id == id)
+				{
+					return &column;
+				}
+			}
+			return nullptr;
+		}
+	};
+
+	struct Record
+	{
+		int      archetype = -1;
+		uint32_t row = 0;
+		uint32_t generation = 1;
+	};
+
+	template <typename... Cs>
+	static uint64_t maskOf()
+	{
+		uint64_t mask = 0;
+		int expand[] = { 0, (mask |= uint64_t(1) << componentId<Cs>(), 0)... };
+		(void)expand;
+		return mask;
+	}
+
+	template <typename... Cs>
+	Archetype& archetypeFor()
+	{
+		uint64_t mask = maskOf<Cs...>();
+		if (Archetype* existing = findArchetype(mask))
+		{
+			return *existing;
+		}
+
+		std::vector<Column> columns;
+		int expand[] = { 0, (columns.push_back(Column::make<Cs>()), 0)... };
+		(void)expand;
+		return addArchetype(mask, std::move(columns));
+	}
+
+	Archetype& archetypeWith(Archetype& from, Column&& extra)
+	{
+		uint64_t mask = from.mask | uint64_t(1) << extra.id;
+		if (Archetype* existing = findArchetype(mask))
+		{
+			return *existing;
+		}
+
+		std::vector<Column> columns;
+		for (Column& column : from.columns)
+		{
+			columns.push_back(column.emptyCopy());
+		}
+		columns.push_back(std::move(extra));
+		return addArchetype(mask, std::move(columns));
+	}
+
+	Archetype& archetypeWithout(Archetype& from, uint32_t id)
+	{
+		uint64_t mask = from.mask & ~(uint64_t(1) << id);
+		if (Archetype* existing = findArchetype(mask))
+		{
+			return *existing;
+		}
+
+		std::vector<Column> columns;
+		for (Column& column : from.columns)
+		{
+			if (column.id != id)
+			{
+				columns.push_back(column.emptyCopy());
+			}
+		}
+		return addArchetype(mask, std::move(columns));
+	}
+
+	Archetype* findArchetype(uint64_t mask)
+	{
+		for (auto& archetype : archetypes)
+		{
+			if (archetype->mask == mask)
+			{
+				return archetype.get();
+			}
+		}
+		return nullptr;
+	}
+
+	Archetype& addArchetype(uint64_t mask, std::vector<Column>&& columns)
+	{
+		std::sort(columns.begin(), columns.end(),
+			[](const Column& a, const Column& b) { return a.id < b.id; });
+
+		archetypes.emplace_back(new Archetype());
+		Archetype& archetype = *archetypes.back();
+		archetype.mask = mask;
+		archetype.columns = std::move(columns);
+		return archetype;
+	}
+
+	Entity allocate()
+	{
+		uint32_t index;
+		if (free_records.empty())
+		{
+			index = static_cast<uint32_t>(records.size());
+			records.emplace_back();
+		}
+		else
+		{
+			index = free_records.back();
+			free_records.pop_back();
+		}
+
+		Entity entity;
+		entity.index = index;
+		entity.generation = records[index].generation;
+		live_count++;
+		return entity;
+	}
+
+	/**
+	*  Gives an entity the next row of an archetype, leaving the row's
+	*  components to be constructed.
+	*/
+	void place(Entity entity, Archetype& archetype)
+	{
+		Record& record = records[entity.index];
+		record.archetype = indexOf(archetype);
+		record.row = static_cast<uint32_t>(archetype.entities.size());
+		archetype.entities.push_back(entity);
+	}
+
+	/**
+	*  Drops a row from an archetype's entity list once its components
+	*  are gone, moving the last entity into the gap.
+	*/
+	void unplace(Archetype& archetype, uint32_t row)
+	{
+		Entity last = archetype.entities.back();
+		archetype.entities[row] = last;
+		archetype.entities.pop_back();
+		if (row < archetype.entities.size())
+		{
+			records[last.index].row = row;
+		}
+	}
+
+	/**
+	*  Moves an entity's row to another archetype. Components that
+	*  aren't in the new archetype are destroyed, and any it has that
+	*  the old one didn't are left to be constructed.
+	*/
+	void move(Entity entity, Archetype& from, Archetype& to)
+	{
+		uint32_t row = records[entity.index].row;
+		for (Column& column : from.columns)
+		{
+			if (Column* target = to.find(column.id))
+			{
+				column.move_to(target->push(), column.at(row));
+			}
+			else
+			{
+				column.destroy(column.at(row));
+			}
+			column.eraseMoved(row);
+		}
+
+		unplace(from, row);
+		place(entity, to);
+	}
+
+	template <typename C>
+	void construct(Archetype& archetype, C&& component)
+	{
+		typedef typename std::decay<C>::type T;
+		new (archetype.find(componentId<T>())->push()) T(std::forward<C>(component));
+	}
+
+	int indexOf(const Archetype& archetype) const
+	{
+		for (size_t i = 0; i < archetypes.size(); i++)
+		{
+			if (archetypes[i].get() == &archetype)
+			{
+				return static_cast<int>(i);
+			}
+		}
+		return -1;
+	}
+
+	template <typename F, typename Columns, size_t... Is>
+	static void eachRow(Archetype& archetype, F& f, Columns columns, std::index_sequence<Is...>)
+	{
+		size_t rows = archetype.entities.size();
+		for (size_t row = 0; row < rows; row++)
+		{
+			f(archetype.entities[row], std::get<Is>(columns)[row]...);
+		}
+	}
+
+	std::vector<std::unique_ptr<Archetype>> archetypes;
+	std::vector<Record>   records;       /**< Where each entity lives, by entity index. */
+	std::vector<uint32_t> free_records;
+	int live_count = 0;
+};
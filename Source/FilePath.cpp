@@ -0,0 +1,55 @@
+#include <ctype.h>
+#include <vector>
+
+#include "FilePath.h"
+
+std::string normalisePath(const std::string& path)
+{
+	std::vector<std::string> parts;
+	bool absolute = !path.empty() && (path[0] == '/' || path[0] == '\\');
+
+	size_t start = 0;
+	while (start <= path.size())
+	{
+		size_t end = path.find_first_of("/\\", start);
+		if (end == std::string::npos)
+		{
+			end = path.size();
+		}
+
+		std::string part = path.substr(start, end - start);
+		if (part == "..")
+		{
+			if (!parts.empty() && parts.back() != "..")
+			{
+				parts.pop_back();
+			}
+			else if (!absolute)
+			{
+				parts.push_back(part);
+			}
+		}
+		else if (!part.empty() && part != ".")
+		{
+			parts.push_back(part);
+		}
+
+		start = end + 1;
+	}
+
+	std::string key = absolute ? "/" : "";
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		key += i > 0 ? "/" : "";
+		key += parts[i];
+	}
+
+#ifdef _WIN32
+	for (char& c : key)
+	{
+		c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+	}
+#endif
+
+	return key;
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+
+/**
+*  Turns a path into a canonical key for it.
+*  Separators become '/', "." segments are dropped and ".." folds
+*  into its parent, so ".\Resources\a.png" and "Resources/a.png"
+*  give the same key. On Windows the path is also lower-cased, as
+*  its file names aren't case sensitive. The file isn't touched.
+*/
+std::string normalisePath(const std::string& path);
@@ -0,0 +1,143 @@
+#pragma once
+#include <stdint.h>
+
+/**
+*  A signed fixed-point number with 16 fractional bits.
+*  Stored in 64 bits. Values, sums, products and quotients may all
+*  reach about ±2^47, as products and quotients are split so that no
+*  intermediate needs more than 64 bits. Floats only come in through
+*  the explicit constructors, so they can't slip into the
+*  deterministic path unnoticed. Every operation is done with integer arithmetic, which gives
+*  bit-identical results on every compiler, optimisation level and
+*  instruction set. Products and quotients round towards negative
+*  infinity.
+*/
+class fixed
+{
+public:
+	static const int     fraction_bits = 16;
+	static const int64_t one = int64_t(1) << fraction_bits;
+
+	constexpr fixed() : raw(0) {}
+	constexpr fixed(int value) : raw(int64_t(value) * one) {}
+	explicit constexpr fixed(float value) : raw(static_cast<int64_t>(value * 65536.0f)) {}
+	explicit constexpr fixed(double value) : raw(static_cast<int64_t>(value * 65536.0)) {}
+
+	/**
+	*  Builds a number directly from its underlying representation.
+	*  @param [in] value The value scaled by 2^16.
+	*  @return the fixed-point number.
+	*/
+	static constexpr fixed fromRaw(int64_t value)
+	{
+		return fixed(value, 0);
+	}
+
+	/**
+	*  The largest value that can be represented.
+	*/
+	static constexpr fixed max()
+	{
+		return fixed(INT64_MAX, 0);
+	}
+
+	constexpr int64_t rawValue() const { return raw; }
+
+	explicit constexpr operator float() const { return static_cast<float>(raw) / 65536.0f; }
+	explicit constexpr operator double() const { return static_cast<double>(raw) / 65536.0; }
+	explicit constexpr operator int() const { return static_cast<int>(raw / one); }
+
+	constexpr fixed operator-() const { return fromRaw(-raw); }
+
+	friend constexpr fixed operator+(fixed a, fixed b) { return fromRaw(a.raw + b.raw); }
+	friend constexpr fixed operator-(fixed a, fixed b) { return fromRaw(a.raw - b.raw); }
+	friend constexpr fixed operator*(fixed a, fixed b) { return fromRaw(mulShift(a.raw, b.raw)); }
+	friend constexpr fixed operator/(fixed a, fixed b) { return fromRaw(divShift(a.raw, b.raw)); }
+
+	fixed& operator+=(fixed rhs) { raw += rhs.raw; return *this; }
+	fixed& operator-=(fixed rhs) { raw -= rhs.raw; return *this; }
+	fixed& operator*=(fixed rhs) { return *this = *this * rhs; }
+	fixed& operator/=(fixed rhs) { return *this = *this / rhs; }
+
+	friend constexpr bool operator==(fixed a, fixed b) { return a.raw == b.raw; }
+	friend constexpr bool operator!=(fixed a, fixed b) { return a.raw != b.raw; }
+	friend constexpr bool operator< (fixed a, fixed b) { return a.raw <  b.raw; }
+	friend constexpr bool operator> (fixed a, fixed b) { return a.raw >  b.raw; }
+	friend constexpr bool operator<=(fixed a, fixed b) { return a.raw <= b.raw; }
+	friend constexpr bool operator>=(fixed a, fixed b) { return a.raw >= b.raw; }
+
+private:
+	constexpr fixed(int64_t value, int) : raw(value) {}
+
+	static constexpr int64_t floorDiv(int64_t a, int64_t b)
+	{
+		return (a % b != 0 && ((a < 0) != (b < 0))) ? a / b - 1 : a / b;
+	}
+
+	/**
+	*  floor(a * b / 2^16). a is split into its whole and fractional
+	*  parts, a = high * 2^16 + low with 0 <= low < 2^16, so each part
+	*  of the product fits in 64 bits for |b| < 2^47.
+	*/
+	static constexpr int64_t mulShift(int64_t a, int64_t b)
+	{
+		return (a >> fraction_bits) * b + (((a & (one - 1)) * b) >> fraction_bits);
+	}
+
+	/**
+	*  floor(a * 2^16 / b). When a * 2^16 would overflow, the whole
+	*  quotient is taken first, then the remainder, which is smaller
+	*  than |b|, is scaled and divided.
+	*/
+	static constexpr int64_t divShift(int64_t a, int64_t b)
+	{
+		return a < (int64_t(1) << 47) && a > -(int64_t(1) << 47) ? floorDiv(a * one, b) :
+			floorDiv(a, b) * one + floorDiv((a - floorDiv(a, b) * b) * one, b);
+	}
+
+	int64_t raw;
+};
+
+/**
+*  Square root of a fixed-point number.
+*  Uses a bit by bit integer square root, so it is exact to the last
+*  bit and the same everywhere. Negative values return 0.
+*/
+inline fixed sqrt(fixed value)
+{
+	if (value.rawValue() <= 0)
+	{
+		return fixed();
+	}
+
+	// sqrt(raw / 2^16) * 2^16 == sqrt(raw * 2^16)
+	uint64_t n = static_cast<uint64_t>(value.rawValue()) << fixed::fraction_bits;
+	uint64_t root = 0;
+	uint64_t bit = uint64_t(1) << 62;
+	while (bit > n)
+	{
+		bit >>= 2;
+	}
+
+	while (bit)
+	{
+		if (n >= root + bit)
+		{
+			n -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+
+		bit >>= 2;
+	}
+
+	return fixed::fromRaw(static_cast<int64_t>(root));
+}
+
+inline fixed abs(fixed value)
+{
+	return value < 0 ? -value : value;
+}
@@ -0,0 +1,58 @@
+#include "FixedTimestep.h"
+
+void FixedTimestep::setTickRate(int ticks_per_second)
+{
+	if (ticks_per_second > 0)
+	{
+		tick_length = 1.0 / ticks_per_second;
+	}
+}
+
+void FixedTimestep::setMaxSteps(int steps)
+{
+	if (steps > 0)
+	{
+		max_steps = steps;
+	}
+}
+
+/**
+*   @brief   Accumulates a frame and counts the ticks to run.
+*   @details The accumulator is clamped to max_steps ticks so a slow
+			 frame can never queue up an unbounded amount of work.
+*   @return  The number of fixed ticks to simulate this frame.
+*/
+int FixedTimestep::advance(double frame_seconds)
+{
+	if (frame_seconds > 0)
+	{
+		accumulator += frame_seconds;
+	}
+
+	double max_accumulated = tick_length * max_steps;
+	if (accumulator > max_accumulated)
+	{
+		accumulator = max_accumulated;
+	}
+
+	int steps = static_cast<int>(accumulator / tick_length);
+	accumulator -= steps * tick_length;
+	interp_alpha = static_cast<float>(accumulator / tick_length);
+	return steps;
+}
+
+void FixedTimestep::reset()
+{
+	accumulator = 0;
+	interp_alpha = 0;
+}
+
+float FixedTimestep::tickLength() const
+{
+	return static_cast<float>(tick_length);
+}
+
+float FixedTimestep::alpha() const
+{
+	return interp_alpha;
+}
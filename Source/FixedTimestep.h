@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+*  Converts variable frame times into a fixed number of ticks.
+*  Frame time is added to an accumulator and consumed in whole
+*  ticks of a constant length, so the simulation always advances
+*  by the same amount no matter how fast the game is rendering.
+*  Whatever is left over is exposed as an interpolation alpha
+*  that the renderer can use to blend between the last two ticks.
+*/
+class FixedTimestep
+{
+public:
+	/**
+	*  Sets how many ticks are simulated per second.
+	*  @param [in] ticks_per_second The tick rate, must be positive.
+	*/
+	void setTickRate(int ticks_per_second);
+
+	/**
+	*  Sets the most ticks that can be run for a single frame.
+	*  After a long hitch the remaining time is dropped rather than
+	*  trying to catch up, which would only make the next frame slower.
+	*  @param [in] steps The catch-up limit.
+	*/
+	void setMaxSteps(int steps);
+
+	/**
+	*  Adds a frame's worth of time to the accumulator.
+	*  @param [in] frame_seconds The length of the frame in seconds.
+	*  @return the number of ticks that should now be simulated.
+	*/
+	int advance(double frame_seconds);
+
+	/**
+	*  Discards any accumulated time.
+	*/
+	void reset();
+
+	float tickLength() const;
+
+	/**
+	*  How far the current frame is between the last tick and the next.
+	*  @return a value between 0 and 1.
+	*/
+	float alpha() const;
+
+private:
+	double tick_length = 1.0 / 120.0;
+	double accumulator = 0;
+	int    max_steps = 8;
+	float  interp_alpha = 0;
+};
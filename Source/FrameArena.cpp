@@ -0,0 +1,124 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "FrameArena.h"
+
+FrameArena::FrameArena(size_t capacity)
+{
+	addBlock(capacity > 0 ? capacity : 1);
+}
+
+/**
+*   @brief   Bumps the pointer in the current block.
+*   @details Moves on to the next block, adding one if needed, when
+			 the allocation doesn't fit. New blocks are at least twice
+			 the size of the last so a busy frame only chains a few.
+*   @return  The memory.
+*/
+void* FrameArena::allocate(size_t bytes, size_t alignment)
+{
+	while (true)
+	{
+		Block& block = blocks[current];
+		uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+		size_t start = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+		if (start + bytes <= block.size)
+		{
+			offset = start + bytes;
+			return block.memory.get() + start;
+		}
+
+		if (current + 1 == blocks.size())
+		{
+			size_t grown = block.size * 2;
+			addBlock(grown > bytes + alignment ? grown : bytes + alignment);
+		}
+
+		current++;
+		offset = 0;
+	}
+}
+
+const char* FrameArena::format(const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	va_list copy;
+	va_copy(copy, args);
+	int length = vsnprintf(nullptr, 0, fmt, copy);
+	va_end(copy);
+
+	char* text = static_cast<char*>(allocate(length > 0 ? length + 1 : 1, 1));
+	if (length > 0)
+	{
+		vsnprintf(text, length + 1, fmt, args);
+	}
+	else
+	{
+		text[0] = '\0';
+	}
+
+	va_end(args);
+	return text;
+}
+
+/**
+*   @brief   Starts the arena again from the beginning.
+*   @details If the last frame spilled into more than one block they
+			 are replaced by a single block as big as all of them.
+*   @return  void
+*/
+void FrameArena::reset()
+{
+	if (blocks.size() > 1)
+	{
+		size_t total = capacity();
+		blocks.clear();
+		addBlock(total);
+	}
+
+	current = 0;
+	offset = 0;
+}
+
+FrameArena::Marker FrameArena::mark() const
+{
+	Marker marker;
+	marker.block = current;
+	marker.offset = offset;
+	return marker;
+}
+
+void FrameArena::rewind(Marker marker)
+{
+	current = marker.block;
+	offset = marker.offset;
+}
+
+size_t FrameArena::used() const
+{
+	size_t total = offset;
+	for (size_t i = 0; i < current; i++)
+	{
+		total += blocks[i].size;
+	}
+	return total;
+}
+
+size_t FrameArena::capacity() const
+{
+	size_t total = 0;
+	for (const Block& block : blocks)
+	{
+		total += block.size;
+	}
+	return total;
+}
+
+void FrameArena::addBlock(size_t min_size)
+{
+	Block block;
+	block.memory.reset(new unsigned char[min_size]);
+	block.size = min_size;
+	blocks.push_back(std::move(block));
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+*  A bump allocator for memory that only lives for one frame.
+*  Allocating moves a pointer along a block of memory and freeing
+*  does nothing, everything is released at once by reset() at the
+*  start of the next frame. If a frame needs more than the block
+*  holds, extra blocks are chained on, and at the next reset they
+*  are merged into one block big enough for the whole frame. After
+*  the first few frames the arena stops asking the heap for memory.
+*/
+class FrameArena
+{
+public:
+	/**
+	*  @param [in] capacity The size of the first block in bytes.
+	*/
+	explicit FrameArena(size_t capacity = 64 * 1024);
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	/**
+	*  Hands out memory that is valid until the next reset().
+	*  @param [in] bytes The size of the allocation.
+	*  @param [in] alignment A power of two.
+	*/
+	void* allocate(size_t bytes, size_t alignment = alignof(max_align_t));
+
+	/**
+	*  Formats a string into the arena, like sprintf.
+	*  @return the string, valid until the next reset().
+	*/
+	const char* format(const char* fmt, ...);
+
+	/**
+	*  Releases everything allocated since the last reset.
+	*  Call once per frame, before anything is allocated for it.
+	*/
+	void reset();
+
+	/**
+	*  A point in the arena that can be rewound to.
+	*  @see FrameScope
+	*/
+	struct Marker
+	{
+		size_t block = 0;
+		size_t offset = 0;
+	};
+
+	Marker mark() const;
+
+	/**
+	*  Releases everything allocated since the marker was taken.
+	*/
+	void rewind(Marker marker);
+
+	size_t used() const;      /**< Bytes passed over since the last reset, padding included. */
+	size_t capacity() const;  /**< Bytes held across every block. */
+
+private:
+	struct Block
+	{
+		std::unique_ptr<unsigned char[]> memory;
+		size_t size = 0;
+	};
+
+	void addBlock(size_t min_size);
+
+	std::vector<Block> blocks;
+	size_t current = 0;     /**< The block being allocated from. */
+	size_t offset = 0;      /**< The next free byte in that block. */
+};
+
+/**
+*  Rewinds a FrameArena when it goes out of scope.
+*  For scratch memory needed only inside one function, so a frame
+*  that calls it many times doesn't keep every copy.
+*/
+class FrameScope
+{
+public:
+	explicit FrameScope(FrameArena& arena) : arena(arena), marker(arena.mark()) {}
+	~FrameScope() { arena.rewind(marker); }
+
+	FrameScope(const FrameScope&) = delete;
+	FrameScope& operator=(const FrameScope&) = delete;
+
+private:
+	FrameArena& arena;
+	FrameArena::Marker marker;
+};
+
+/**
+*  A standard allocator that takes its memory from a FrameArena.
+*  Containers using it must be gone before the arena is reset.
+*/
+template <typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+
+	FrameAllocator(FrameArena& arena) : arena(&arena) {}
+
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other) : arena(other.arena) {}
+
+	T* allocate(size_t count)
+	{
+		return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T*, size_t) {}
+
+	template <typename U>
+	bool operator==(const FrameAllocator<U>& rhs) const { return arena == rhs.arena; }
+
+	template <typename U>
+	bool operator!=(const FrameAllocator<U>& rhs) const { return arena != rhs.arena; }
+
+private:
+	template <typename U> friend class FrameAllocator;
+	FrameArena* arena;
+};
+
+typedef std::basic_string<char, std::char_traits<char>, FrameAllocator<char>> frame_string;
+
+template <typename T>
+using frame_vector = std::vector<T, FrameAllocator<T>>;
@@ -5,9 +5,8 @@
 #include <Engine/InputEvents.h>
 #include <Engine/Sprite.h>
 
+#include "AllocAudit.h"
 #include "Game.h"
-#include "Vector2.h"
-//#include "Vector1.h"
 
 /**
 *   @brief   Default Constructor.
@@ -41,6 +40,14 @@ BreakoutGame::~BreakoutGame()
 */
 bool BreakoutGame::init()
 {
+	// files are read and decoded on the asset loader's workers while
+	// the window opens, only the textures are made on this thread
+	if (!manifest.load(".\\Resources\\breakout.manifest"))
+	{
+		return false;
+	}
+	std::shared_future<bool> assets_ready = assets.start(manifest);
+
 	setupResolution();
 	if (!initAPI())
 	{
@@ -50,6 +57,10 @@ bool BreakoutGame::init()
 	toggleFPS();
 	renderer->setWindowTitle("Breakout!");
 	renderer->setClearColour(ASGE::COLOURS::BLACK);
+	// every entity of a kind shares one texture and they are drawn a
+	// kind at a time, so consecutive draws batch together
+	renderer->setSpriteMode(ASGE::SpriteSortMode::DEFERRED);
+	textures.setRenderer(renderer.get());
 	// input handling functions
 	inputs->use_threads = false;
 
@@ -60,50 +71,66 @@ bool BreakoutGame::init()
 		ASGE::E_MOUSE_CLICK, &BreakoutGame::clickHandler, this);
 
 
-	if (!paddle.addSpriteComponent(renderer.get(), ".\\Resources\\Textures\\puzzlepack\\png\\paddleBlue.png"))
+	// a file the loader couldn't decode, such as an interlaced PNG, is
+	// loaded by ASGE from the file instead and gets no collision mask
+	assets_ready.wait();
+	textures.setImages(&assets);
+
+	// sprites packed into the atlas are drawn from it, see --pack-atlas
+	atlas = assets.atlas();
+	if (!loadSprite("paddle", paddle_sprite) ||
+		!loadSprite("ball", ball_sprite) ||
+		!loadSprite("block", block_sprite) ||
+		!loadSprite("gem", gem_sprite))
 	{
 		return false;
 	}
 
-	paddle_sprite = paddle.spriteComponent()->getSprite();
-	paddle_sprite->xPos(game_width / 2);
-
-	if (!ball.addSpriteComponent(renderer.get(), ".\\Resources\\Textures\\puzzlepack\\png\\ballGrey.png"))
+	Transform paddle_transform = spriteTransform(paddle_sprite);
+	Transform ball_transform = spriteTransform(ball_sprite);
+	Transform gem_transform = spriteTransform(gem_sprite);
+
+	SimConfig config;
+	config.game_width = game_width;
+	config.game_height = game_height;
+	config.paddle_width = paddle_transform.size().x;
+	config.paddle_height = paddle_transform.size().y;
+	config.ball_width = ball_transform.size().x;
+	config.ball_height = ball_transform.size().y;
+	config.gem_width = gem_transform.size().x;
+	config.gem_height = gem_transform.size().y;
+	config.seed = static_cast<unsigned int>(rand());
+	config.gem_balls = gem_balls;
+
+	auto paddle_mask = std::make_shared<CollisionMask>();
+	auto gem_mask = std::make_shared<CollisionMask>();
+	if (assets.buildCollisionMask(manifest.find("paddle")->path, *paddle_mask) &&
+		assets.buildCollisionMask(manifest.find("gem")->path, *gem_mask))
 	{
-		return false;
+		config.paddle_mask = paddle_mask;
+		config.gem_mask = gem_mask;
 	}
-	ball_sprite = ball.spriteComponent()->getSprite();
-	ball_sprite->yPos(game_height / 2);
-	ball_sprite->xPos(game_width / 2);
 
+	simulation.init(config);
+	previous_state = simulation.state();
 
-	for (int i = 0; i < max_sprites; i++)
+	// created in the order they are drawn
+	entities.create(paddle_transform, Renderable{ paddle_sprite }, PaddleLink{});
+	syncBalls(1.0f);
+	for (int i = 0; i < simulation.state().blocks.size(); i++)
 	{
-
-		if (!blocks[i].addSpriteComponent(renderer.get(), ".\\Resources\\Textures\\puzzlepack\\png\\element_red_rectangle.png"))
-		{
-			return false;
-		}
-		ASGE::Sprite* block_sprite = blocks[i].spriteComponent()->getSprite();
-		
+		entities.create(spriteTransform(block_sprite), Renderable{ block_sprite }, BlockLink{ i });
 	}
-
-	for (int i = 0; i < max_gems; i++)
+	for (int i = 0; i < SimState::max_gems; i++)
 	{
-		if
-			(!gems[i].addSpriteComponent(renderer.get(), ".\\Resources\\Textures\\puzzlepack\\png\\element_blue_diamond.png"))
-		{
-			return false;
-		}
-		
-		gems[i].setVisibility(false);
-		ASGE::Sprite* gem_sprite = gems[i].spriteComponent()->getSprite();
-		gem_sprite->yPos(rand() % 1 + -2000);
-		gem_sprite->xPos(1 + rand() % game_width - gem_width);
-
+		entities.create(gem_transform, Renderable{ gem_sprite }, GemLink{ i });
 	}
 
-	gems[0].setVisibility(true);
+	use_fixed_timestep = true;
+	timestep.setTickRate(120);
+	timestep.setMaxSteps(8);
+
+	syncTransforms(1.0f);
 	return true;
 }
 
@@ -129,18 +156,30 @@ void BreakoutGame::setupResolution()
 /**
 *   @brief   Processes any key inputs
 *   @details This function is added as a callback to handle the game's
-			 keyboard input. For this game, calls to this function
-			 are thread safe, so you may alter the game's state as you
-			 see fit.
+			 keyboard input. The key is queued in the frame arena and
+			 acted on at the start of the next update, so handling it
+			 never touches the heap.
 *   @param   data The event data relating to key input.
 *   @see     KeyEvent
 *   @return  void
 */
 void BreakoutGame::keyHandler(const ASGE::SharedEventData data)
 {
+	AllocScope alloc_scope(FramePhase::INPUT);
 	auto key = static_cast<const ASGE::KeyEvent*>(data.get());
-	
-	if (key->key == ASGE::KEYS::KEY_ESCAPE)
+	key_presses.push_back(KeyPress{ key->key, key->action });
+}
+
+/**
+*   @brief   Acts on a key press or release
+*   @details Called by update() for each key queued since the last
+			 frame, in the order they arrived.
+*   @param   key The key and whether it was pressed or released.
+*   @return  void
+*/
+void BreakoutGame::applyKey(const KeyPress& key)
+{
+	if (key.key == ASGE::KEYS::KEY_ESCAPE)
 	{
 		signalExit();
 	}
@@ -148,37 +187,44 @@ void BreakoutGame::keyHandler(const ASGE::SharedEventData data)
 	
 	if (in_menu)
 	{
-		if (key->key == ASGE::KEYS::KEY_ENTER)
+		if (key.key == ASGE::KEYS::KEY_ENTER)
 		{
 			in_menu = 0;
 		}
 	}
 
+	if (!in_menu &&
+		key.key == ASGE::KEYS::KEY_P &&
+		key.action == ASGE::KEYS::KEY_PRESSED)
+	{
+		ai_paddle = !ai_paddle;
+	}
+
 	if (!in_menu)
 		
 		//Bool Statements to make paddle move left
-		if (key->key == ASGE::KEYS::KEY_A &&
-			key->action == ASGE::KEYS::KEY_PRESSED)
+		if (key.key == ASGE::KEYS::KEY_A &&
+			key.action == ASGE::KEYS::KEY_PRESSED)
 		{
 			paddle_left = true;
 			 
 		}
 
-	if (key->key == ASGE::KEYS::KEY_A &&
-		key->action == ASGE::KEYS::KEY_RELEASED)
+	if (key.key == ASGE::KEYS::KEY_A &&
+		key.action == ASGE::KEYS::KEY_RELEASED)
 	{
 		paddle_left = false;
 	}
 
 	//Bool Statements to make paddle move right
-	if (key->key == ASGE::KEYS::KEY_D &&
-		key->action == ASGE::KEYS::KEY_PRESSED)
+	if (key.key == ASGE::KEYS::KEY_D &&
+		key.action == ASGE::KEYS::KEY_PRESSED)
 	{
 		paddle_right = true;
 	}
 
-	if (key->key == ASGE::KEYS::KEY_D &&
-		key->action == ASGE::KEYS::KEY_RELEASED)
+	if (key.key == ASGE::KEYS::KEY_D &&
+		key.action == ASGE::KEYS::KEY_RELEASED)
 	{
 		paddle_right = false;
 	}
@@ -196,6 +242,7 @@ void BreakoutGame::keyHandler(const ASGE::SharedEventData data)
 */
 void BreakoutGame::clickHandler(const ASGE::SharedEventData data)
 {
+	AllocScope alloc_scope(FramePhase::INPUT);
 	auto click = static_cast<const ASGE::ClickEvent*>(data.get());
 
 	double x_pos, y_pos;
@@ -212,171 +259,235 @@ void BreakoutGame::clickHandler(const ASGE::SharedEventData data)
 */
 void BreakoutGame::update(const ASGE::GameTime& us)
 {
-
-	if (!in_menu)
+	// the keys queued since the last frame are held in the frame
+	// arena, so they are applied and dropped before it is reset
+	for (const KeyPress& key : key_presses)
 	{
+		applyKey(key);
+	}
+	frame_vector<KeyPress>(FrameAllocator<KeyPress>(frame_arena)).swap(key_presses);
 
-			elapsed_time += (us.game_time.count() / 1000);
-			int gem_drop = 10;
-		
-
-		auto paddle_pos = paddle_sprite->xPos();
-
-		auto y_pos = ball_sprite->yPos();
-		auto x_pos = ball_sprite->xPos();
-
-		BallCollider(x_pos, y_pos);
-
-
-		BrickCollider();
-
-
-		PaddleMovement(paddle_pos, us);
-
-		updateBall(x_pos, us, y_pos);
+	// a new frame, ASGE's beginFrame can't be overridden so the
+	// frame's scratch memory is released here instead
+	frame_arena.reset();
+	allocAuditEndFrame();
+	AllocScope alloc_scope(FramePhase::UPDATE);
+	double frame_seconds = us.delta_time.count() / 1000.0;
 
-		for (int i = 0; i < max_gems; i++)
+	if (!in_menu)
+	{
+		SimInput input;
+		input.paddle_left = paddle_left;
+		input.paddle_right = paddle_right;
+		if (ai_paddle)
 		{
+			real hold;
+			input = predictor.steer(simulation, hold);
+		}
 
-			if (elapsed_time >= gem_drop)
+		if (use_fixed_timestep)
+		{
+			int steps = timestep.advance(frame_seconds);
+			for (int i = 0; i < steps; i++)
 			{
+				previous_state = simulation.state();
+				simulation.step(timestep.tickLength(), input);
+			}
 
-				if (gems[i].isvisible())
-				{
-
-					ASGE::Sprite* gem_sprite = gems[i].spriteComponent()->getSprite();
-
-					float gem_y_pos = gem_sprite->yPos();
-
-					gem_y_pos += 150 * (us.delta_time.count() / 1000.f);
-					gem_sprite->yPos(gem_y_pos);
-
-
-					if (gems[i].spriteComponent()->getBoundingBox().isInside(
-						paddle.spriteComponent()->getBoundingBox()) == true
-						&& gems[i].isvisible())
-					{
-						gems[i].spriteComponent()->getSprite()->xPos(rand() % 1 + game_width - gem_width);
-						gems[i].spriteComponent()->getSprite()->yPos(rand() % 1 + -200);
+			syncTransforms(timestep.alpha());
+		}
+		else
+		{
+			simulation.step(static_cast<real>(frame_seconds), input);
+			syncTransforms(1.0f);
+		}
 
-						score += 10000;
+#ifdef BREAKOUT_COROUTINES
+		if (simulation.isOver() && !level_ending)
+		{
+			level_ending = true;
+			scripts.start(levelTransition());
+		}
+#endif
+	}
 
+#ifdef BREAKOUT_COROUTINES
+	scripts.update(frame_seconds);
+#endif
+}
 
-						break;
-					}
+#ifdef BREAKOUT_COROUTINES
+/**
+*   @brief   Moves on from a finished level
+*   @details Leaves the win or lose screen up for a few seconds, then
+			 goes back to the menu with a fresh level.
+*   @return  The script, for a ScriptScheduler to run
+*/
+Script BreakoutGame::levelTransition()
+{
+	co_await after(std::chrono::seconds(5));
+	restartLevel();
+}
+#endif
 
-					if (gem_sprite->yPos() >= game_height)
-					{
-						gems[i].spriteComponent()->getSprite()->xPos(rand() % 1 + game_width - gem_width);
-						gems[i].spriteComponent()->getSprite()->yPos(rand() % 1 + -200);
+/**
+*   @brief   Lays out a new level and shows the menu
+*   @details The simulation keeps its config, so only the state is
+			 rebuilt and the entities are synced to it.
+*   @return  void
+*/
+void BreakoutGame::restartLevel()
+{
+	simulation.init(simulation.getConfig());
+	previous_state = simulation.state();
+	timestep.reset();
+	syncTransforms(1.0f);
+	paddle_left = false;
+	paddle_right = false;
+	level_ending = false;
+	in_menu = true;
+}
 
-						break;
+/**
+*   @brief   Blends between two values
+*   @return  a when t is 0, b when t is 1
+*/
+static float interpolate(float a, float b, float t)
+{
+	return a + (b - a) * t;
+}
 
-					}
+/**
+*   @brief   Copies the simulation state onto the entities
+*   @details The simulation owns every position, the transforms only
+			 mirror it so they can be drawn. Moving objects are blended
+			 between the previous and current tick using alpha. Each
+			 kind of entity is one pass over its own archetype.
+*   @param   alpha How far between the last two ticks to draw.
+*   @return  void
+*/
+void BreakoutGame::syncTransforms(float alpha)
+{
+	const SimState& state = simulation.state();
+	const SimState& prev = previous_state;
 
-					elapsed_time = 0;
-				}
-			}
-		}
-	}
-}
-
-void BreakoutGame::BallCollider(float &x_pos, float &y_pos)
-{
-	//Wall Collision
-	if ((ball_sprite->xPos() + ball_sprite->width() >= game_width) ||
-		(ball_sprite->xPos() < 0))
+	entities.each<Transform, PaddleLink>([&](Entity, Transform& transform, PaddleLink&)
 	{
-		ball_direction.x_set(ball_direction.get_x() * -1);
-	}
+		transform.setPosition(vec2(
+			interpolate(toFloat(prev.paddle.x), toFloat(state.paddle.x), alpha),
+			toFloat(state.paddle.y)));
+	});
 
-	//Ceiling Collision
-	if (ball_sprite->yPos() < 0)
-	{
-		ball_direction.y_set(ball_direction.get_y() * -1);
-	}
+	syncBalls(alpha);
 
-	//Floor Reset
-	if (ball_sprite->yPos() > game_height + 50)
 	{
-		reset(x_pos, y_pos);
-		--player_life;
+		AllocScope alloc_scope(FramePhase::BLOCKS, true);
+		const BrickField& field = state.blocks;
+		entities.each<Transform, Renderable, BlockLink>(
+			[&](Entity, Transform& transform, Renderable& renderable, BlockLink& link)
+		{
+			renderable.visible = link.index < field.size() && field.isAlive(link.index);
+			if (renderable.visible)
+			{
+				transform.setPosition(vec2(field.xs()[link.index], field.ys()[link.index]));
+			}
+		});
 	}
 
-	//Paddle Collision
-	if (ball.spriteComponent()->getBoundingBox().isInside(
-		paddle.spriteComponent()->getBoundingBox()))
+	entities.each<Transform, Renderable, GemLink>(
+		[&](Entity, Transform& transform, Renderable& renderable, GemLink& link)
 	{
-		ball_direction.y_set(ball_direction.get_y() * -1);
-		ball_direction.x_set(ball_direction.get_x() * 1);
-	}
+		int i = link.index;
+		float gem_y = toFloat(state.gems[i].y);
+		float prev_y = toFloat(prev.gems[i].y);
+		transform.setPosition(vec2(toFloat(state.gems[i].x),
+			gem_y >= prev_y ? interpolate(prev_y, gem_y, alpha) : gem_y));
+		renderable.visible = state.gem_visible[i];
+	});
 }
 
-void BreakoutGame::BrickCollider()
+/**
+*   @brief   Matches the ball entities to the balls in play
+*   @details Entities are added or removed so there is one per ball,
+			 then placed. Balls are blended between ticks unless one
+			 was lost or added, or the ball was just reset after
+			 losing a life.
+*   @param   alpha How far between the last two ticks to draw.
+*   @return  void
+*/
+void BreakoutGame::syncBalls(float alpha)
 {
-	//Block Collision
-	for (int i = 0; i < max_sprites; i++)
+	const SimState& state = simulation.state();
+	const SimState& prev = previous_state;
+
+	while (ball_entities.size() < state.balls.size())
 	{
-		if (blocks[i].spriteComponent()->getBoundingBox().isInside(
-			ball.spriteComponent()->getBoundingBox()) == true
-			&& blocks[i].isvisible())
-		{
-			ball_direction.y_set(ball_direction.get_y() * -1);
-			ball_direction.x_set(ball_direction.get_x() * 1);
-			ball_direction.normalise();
-			blocks[i].setVisibility(false);
-			blocks_hit++;
-			score+=150;
-			break;
-		}
-		
+		int index = static_cast<int>(ball_entities.size());
+		ball_entities.push_back(entities.create(
+			spriteTransform(ball_sprite), Renderable{ ball_sprite }, BallLink{ index }));
 	}
-}
 
-void BreakoutGame::PaddleMovement(float &paddle_pos, const ASGE::GameTime & us)
-{
-	//Paddle Movement speed
-	if (paddle_left)
+	while (ball_entities.size() > state.balls.size())
 	{
-		if (paddle_sprite, paddle_pos >= 0)
-		{
-			paddle_pos -= paddle.velocity * (us.delta_time.count() / 1000.f);
-		}
-
-		else
-		{
-			paddle_left = false;
-		}
+		entities.destroy(ball_entities.back());
+		ball_entities.pop_back();
 	}
 
-	if (paddle_right)
+	bool blend = prev.player_life == state.player_life &&
+		prev.balls.size() == state.balls.size();
+
+	entities.each<Transform, BallLink>([&](Entity, Transform& transform, BallLink& link)
 	{
-		if (paddle_sprite, paddle_pos + paddle_sprite->width() <= game_width)
+		const rect& box = state.balls[link.index].box;
+		float x = toFloat(box.x);
+		float y = toFloat(box.y);
+		if (blend)
 		{
-			paddle_pos += paddle.velocity * (us.delta_time.count() / 1000.f);
+			x = interpolate(toFloat(prev.balls[link.index].box.x), x, alpha);
+			y = interpolate(toFloat(prev.balls[link.index].box.y), y, alpha);
 		}
 
-		else
-		{
-			paddle_right = false;
-		}
+		transform.setPosition(vec2(x, y));
+	});
+}
 
+/**
+*   @brief   Loads a texture into a new pooled sprite
+*   @details The texture is found by its name in the manifest.
+*   @return  True if the texture loaded.
+*/
+bool BreakoutGame::loadSprite(const std::string& asset_name,
+	Pool<SpriteComponent>::Handle& handle)
+{
+	const AssetEntry* asset = manifest.find(asset_name);
+	if (!asset)
+	{
+		return false;
 	}
 
+	const std::string& texture_file_name = asset->path;
+	handle = sprites.acquire();
+	SpriteComponent* sprite = sprites.get(handle);
 
-	//Position Updates
-	paddle_sprite->xPos(paddle_pos);
-}
+	if (sprite->loadSprite(textures, atlas, TextureAtlas::spriteName(texture_file_name)) ||
+		sprite->loadSprite(textures, texture_file_name))
+	{
+		return true;
+	}
 
+	sprites.release(handle);
+	return false;
+}
 
-void BreakoutGame::updateBall(float &x_pos, const ASGE::GameTime & us, float &y_pos)
+/**
+*   @brief   A transform the size of a sprite, at the origin
+*   @return  The transform.
+*/
+Transform BreakoutGame::spriteTransform(Pool<SpriteComponent>::Handle handle)
 {
-	
-	//Ball Speed
-	x_pos += (ball.velocity / 2) * ball_direction.get_x() * (us.delta_time.count() / 1000.f);
-	y_pos += (ball.velocity / 2) * ball_direction.get_y() * (us.delta_time.count() / 1000.f);
-	ball_sprite->xPos(x_pos);
-	ball_sprite->yPos(y_pos);
+	Transform transform;
+	transform.setSize(sprites.get(handle)->size());
+	return transform;
 }
 
 /**
@@ -388,6 +499,7 @@ void BreakoutGame::updateBall(float &x_pos, const ASGE::GameTime & us, float &y_
 */
 void BreakoutGame::render(const ASGE::GameTime & us)
 {
+	AllocScope alloc_scope(FramePhase::RENDER);
 	//int rand_pos = (rand() % game_width);
 	
 	
@@ -399,32 +511,31 @@ void BreakoutGame::render(const ASGE::GameTime & us)
 		renderer->renderText("\tWelcome to Breakout \nBreak all bricks on screen. \nYou have 3 lives. \nLives are lost when you miss the ball.\nPress Enter to start game",
 			200, 200, 1.0, ASGE::COLOURS::WHITE);
 	}
-	else if (player_life > 0 && blocks_hit != 50)
+	else if (!simulation.isOver())
 	{
-		std::string life_str = "LIVES: " + std::to_string(player_life);
-		std::string score_str = "SCORE: " + std::to_string(score);
+		// the text is dead once drawn, so don't keep it for the frame
+		FrameScope text_scope(frame_arena);
+		const SimState& state = simulation.state();
+		const char* life_str = frame_arena.format("LIVES: %d", state.player_life);
+		const char* score_str = frame_arena.format("SCORE: %d", state.score);
 		renderer->renderText(score_str, 500, 850, 1.0, ASGE::COLOURS::WHITE);
 		renderer->renderText(life_str, 500, 900, 1.0, ASGE::COLOURS::WHITE);
-		renderer->renderSprite(*paddle_sprite);
-		paddle_sprite->xPos(); //predefined in init
-		paddle_sprite->yPos(game_height - 100); //umnoving
-
-		renderer->renderSprite(*ball_sprite);
-
-		BlockUpdate();
-	
 
-		for (int i = 0; i < max_gems; i++)
+		// the paddle, balls, blocks and gems, each a linear pass over
+		// their archetype
+		entities.each<Transform, Renderable>(
+			[this](Entity, Transform& transform, Renderable& renderable)
 		{
-			if (gems[i].isvisible())
+			if (renderable.visible)
 			{
-				ASGE::Sprite* gem_sprite = gems[i].spriteComponent()->getSprite();
-				renderer->renderSprite(*gem_sprite);
+				SpriteComponent* sprite = sprites.get(renderable.sprite);
+				sprite->applyTransform(transform);
+				renderer->renderSprite(*sprite->getSprite());
 			}
-		}
+		});
 	}
 
-	else if (player_life <= 0)
+	else if (simulation.isLost())
 	{
 		lose();
 	}
@@ -435,64 +546,10 @@ void BreakoutGame::render(const ASGE::GameTime & us)
 	}
 }
 
-void BreakoutGame::BlockUpdate()
-{
-	int x_block_total = 0;
-	int y_block_total = 0;
-
-	for (int i = 0; i < max_sprites; i++)
-	{
-		ASGE::Sprite* block_sprite = blocks[i].spriteComponent()->getSprite();
-		
-		blocks[i].spriteComponent()->getSprite()->xPos(x_block_total * block_width);
-		blocks[i].spriteComponent()->getSprite()->yPos(y_block_total * block_height);
-		
-		if (blocks_hit >= 10)
-		{
-			blocks[i].spriteComponent()->getSprite()->yPos((y_block_total * block_height) + 30);
-		}
-
-		if (blocks_hit >= 20)
-		{
-			blocks[i].spriteComponent()->getSprite()->yPos((y_block_total * block_height) + 60);
-		}
-
-		if (blocks_hit >= 30)
-		{
-			blocks[i].spriteComponent()->getSprite()->yPos((y_block_total * block_height) + 90);
-		}
-
-	
-		x_block_total++;
-		if (i == 9 || i == 19 || i == 29 || i == 39 || i == 49)
-		{
-			x_block_total = 0;
-			y_block_total++;
-		}
-		
-		if (blocks[i].isvisible())
-		{
-			renderer->renderSprite(*blocks[i].spriteComponent()->getSprite());
-			
-		}
-
-	}
-	
-}
-
-
-void BreakoutGame::reset(float& x_pos, float& y_pos)
-{
-	
-	x_pos = game_width / 2;
-	y_pos = game_height / 2;
-	
-}
-
 void BreakoutGame::win()
 {
 	renderer->renderText("CONGRATULATIONS \nYOU WIN", 100, 400, 2.0, ASGE::COLOURS::RED);
-	std::string score_str = "SCORE WAS:  " + std::to_string(score);
+	const char* score_str = frame_arena.format("SCORE WAS:  %d", simulation.state().score);
 	renderer->renderText(score_str, 100, 450, 1.0, ASGE::COLOURS::RED);
 }
 
@@ -2,9 +2,20 @@
 #include <string>
 #include <Engine/OGLGame.h>
 
-#include "GameObject.h"
+#include "AssetLoader.h"
+#include "AssetManifest.h"
+#include "Components.h"
+#include "EntityStore.h"
+#include "FixedTimestep.h"
+#include "FrameArena.h"
+#include "Pool.h"
 #include "Rect.h"
-#include "Vector1.h"
+#include "Script.h"
+#include "Simulation.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "Transform.h"
+#include "TrajectoryPredictor.h"
 
 /**
 *  An OpenGL Game based on ASGE.
@@ -18,61 +29,80 @@ public:
 	virtual bool init() override;
 
 private:
+	/**
+	*  A key event, copied out of ASGE's shared event data.
+	*/
+	struct KeyPress
+	{
+		int key;
+		int action;
+	};
+
 	void keyHandler(const ASGE::SharedEventData data);
+	void applyKey(const KeyPress& key);
 	void clickHandler(const ASGE::SharedEventData data);
 	void setupResolution();
 
-	virtual void update(const ASGE::GameTime &) override;
-	void BallCollider(float &x_pos, float &y_pos);
-	void PaddleMovement(float &paddle_pos, const ASGE::GameTime & us);
-	void BrickCollider();
-	void updateBall(float &x_pos, const ASGE::GameTime & us, float &y_pos);
+	virtual void update(const ASGE::GameTime &) override;
+	void syncTransforms(float alpha);
+	void syncBalls(float alpha);
 	virtual void render(const ASGE::GameTime &) override;
 
-	void BlockUpdate();
+	bool loadSprite(const std::string& asset_name, Pool<SpriteComponent>::Handle& handle);
+	Transform spriteTransform(Pool<SpriteComponent>::Handle handle);
 
 	int  key_callback_id = -1;	        /**< Key Input Callback ID. */
 	int  mouse_callback_id = -1;        /**< Mouse Input Callback ID. */
 
 	void win();
 	void lose();
+	void restartLevel();
+#ifdef BREAKOUT_COROUTINES
+	Script levelTransition();
+#endif
+
+	//Entities mirror the simulation so it can be drawn
+	EntityStore entities;
+	std::vector<Entity> ball_entities;  /**< One per ball in play, in the same order. */
 
-	//Add your GameObjects
-	GameObject paddle;
-	ASGE::Sprite* paddle_sprite;
+	//One sprite per kind of entity, shared by every entity of that kind
+	AssetManifest manifest;             /**< Every file the game loads, named. */
+	AssetLoader assets;                 /**< Reads and decodes the manifest's files at startup. */
+	TextureCache textures;              /**< Each texture file is loaded once, see TextureCache. */
+	TextureAtlas atlas;                 /**< Packed sprites, used in place of their own files when present. */
+	Pool<SpriteComponent> sprites;
+	Pool<SpriteComponent>::Handle paddle_sprite;
+	Pool<SpriteComponent>::Handle ball_sprite;
+	Pool<SpriteComponent>::Handle block_sprite;
+	Pool<SpriteComponent>::Handle gem_sprite;
 	
 //Paddle movement bool
 	bool paddle_left = false;
 	bool paddle_right = false;
-	
-	float elapsed_time = 0;
 
-	
-GameObject ball;
-	ASGE::Sprite* ball_sprite;
-	vector2 ball_direction{1, 1 };
-	void reset(float& x_pos, float& y_pos);
+	//Gameplay state, owned by the headless simulation
+	Simulation simulation;
+	SimState previous_state;            /**< State before the last tick, used for interpolation. */
+	FrameArena frame_arena;             /**< Scratch memory for the current frame, see FrameArena. */
+	frame_vector<KeyPress> key_presses{ FrameAllocator<KeyPress>(frame_arena) };  /**< Keys since the last update. */
+	int  gem_balls = 0;                 /**< Balls a caught gem releases, multi-ball play when above 0. */
 
-	//Block objects and data
-	GameObject blocks[50] = {};
-	//ASGE::Sprite* blocks_sprites[50] = {};
-	
-	GameObject gems[5] = {};
-	//ASGE::Sprite* gem_sprites[5] = {};
+	//Computer controlled paddle, toggled with P
+	TrajectoryPredictor predictor;
+	bool ai_paddle = false;
+
+	//Fixed timestep, opt in with use_fixed_timestep
+	FixedTimestep timestep;
+	bool use_fixed_timestep = false;
 
-	int max_sprites = 50;
-	int blocks_hit = 0;
-	int block_width = 64;
-	int block_height = 32;
-	
-	int max_gems = 5;
-	int gem_width = 48;
-	int gem_height = 48;
-	int gems_caught = 0;
 	//menu options
 	bool in_menu = true;
-	int player_life = 3;
-	int score = (0 + gems_caught);
+
+	//Timed events, written as scripts where coroutines are available
+#ifdef BREAKOUT_COROUTINES
+	ScriptScheduler scripts;
+#endif
+	bool level_ending = false;          /**< The level is over and the transition has started. */
 	
 	
 };
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Reports.h"
+
+/**
+*   @brief   Runs the simulation reports without a window.
+*   @details Built by CMake as breakout_headless, for machines with no
+			 renderer such as CI. Takes the same --stress and --launch
+			 options as the game, and writes the report to stdout.
+*/
+int main(int argc, char** argv)
+{
+	const char* mode = argc > 1 ? argv[1] : "";
+	int count = argc > 2 ? atoi(argv[2]) : 0;
+
+	if (!strcmp(mode, "--stress"))
+	{
+		writeStressReport(stdout, count);
+		return 0;
+	}
+
+	if (!strcmp(mode, "--launch"))
+	{
+		writeLaunchReport(stdout, count > 0 ? count : 1000);
+		return 0;
+	}
+
+	fprintf(stderr, "usage: breakout_headless --stress [balls] | --launch [angles]\n");
+	return 1;
+}
@@ -0,0 +1,1314 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <new>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PNG_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include "PngCodec.h"
+
+void Image::resize(int new_width, int new_height)
+{
+	width = new_width > 0 ? new_width : 0;
+	height = new_height > 0 ? new_height : 0;
+	pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+}
+
+namespace
+{
+	const unsigned char png_signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+	const size_t max_pixels = size_t(1) << 26;   /**< 256MB of RGBA, far past any texture. */
+	const size_t max_inflate_ratio = 1032;       /**< Deflate can't expand data by more. */
+
+	const short length_base[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	const short length_extra[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	const short distance_base[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+		8193, 12289, 16385, 24577 };
+	const short distance_extra[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	uint32_t readBE32(const unsigned char* p)
+	{
+		return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+	}
+
+	void writeBE32(std::vector<unsigned char>& out, uint32_t value)
+	{
+		out.push_back(static_cast<unsigned char>(value >> 24));
+		out.push_back(static_cast<unsigned char>(value >> 16));
+		out.push_back(static_cast<unsigned char>(value >> 8));
+		out.push_back(static_cast<unsigned char>(value));
+	}
+
+	struct CrcTable
+	{
+		uint32_t entries[256];
+
+		CrcTable()
+		{
+			for (uint32_t n = 0; n < 256; n++)
+			{
+				uint32_t c = n;
+				for (int k = 0; k < 8; k++)
+				{
+					c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+				}
+				entries[n] = c;
+			}
+		}
+	};
+
+	uint32_t crc32(const unsigned char* data, size_t size, uint32_t crc = 0)
+	{
+		// built on first use, which is thread safe for a local static
+		static const CrcTable table;
+
+		crc = ~crc;
+		for (size_t i = 0; i < size; i++)
+		{
+			crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		}
+		return ~crc;
+	}
+
+	uint32_t adler32(const unsigned char* data, size_t size)
+	{
+		uint32_t a = 1;
+		uint32_t b = 0;
+		while (size > 0)
+		{
+			// the largest run that can't overflow b before the modulo
+			size_t run = size < 5552 ? size : 5552;
+			size -= run;
+			for (size_t i = 0; i < run; i++)
+			{
+				a += *data++;
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+		}
+		return (b << 16) | a;
+	}
+
+	struct ByteRange
+	{
+		const unsigned char* data;
+		size_t size;
+	};
+
+	/**
+	*  Reads a deflate stream a bit at a time, lowest bit first.
+	*  The stream may be split over several ranges, such as the IDAT
+	*  chunks of a PNG, which are read in place rather than joined.
+	*/
+	struct BitReader
+	{
+		const std::vector<ByteRange>& parts;
+		size_t   next_part = 0;
+		const unsigned char* data = nullptr;
+		size_t   size = 0;
+		size_t   pos = 0;
+		uint32_t buffer = 0;
+		int      count = 0;
+		bool     overrun = false;
+
+		explicit BitReader(const std::vector<ByteRange>& parts) : parts(parts) {}
+
+		// moves on to the next range once the current one is used up
+		bool refill()
+		{
+			while (pos >= size && next_part < parts.size())
+			{
+				data = parts[next_part].data;
+				size = parts[next_part].size;
+				pos = 0;
+				next_part++;
+			}
+			return pos < size;
+		}
+
+		int bits(int need)
+		{
+			uint32_t value = buffer;
+			while (count < need)
+			{
+				if (pos >= size && !refill())
+				{
+					overrun = true;
+					return 0;
+				}
+				value |= uint32_t(data[pos++]) << count;
+				count += 8;
+			}
+
+			buffer = value >> need;
+			count -= need;
+			return static_cast<int>(value & ((1u << need) - 1));
+		}
+
+		// a whole byte, once the reader is on a byte boundary
+		int byte()
+		{
+			return bits(8);
+		}
+	};
+
+	/**
+	*  Where inflate writes, handing the output on a row at a time.
+	*  Only the last 32K is kept for back references, so the whole
+	*  inflated image is never held at once. The buffer is compacted
+	*  once it reaches a few times that, to keep the moves rare.
+	*/
+	struct InflateWindow
+	{
+		static const size_t history = 32768;
+
+		std::vector<unsigned char> data;
+		size_t start = 0;   // the first byte not yet handed on
+		size_t row_length;
+		size_t compact_size;
+		std::function<bool(const unsigned char*)> row;
+
+		InflateWindow(size_t row_length, const std::function<bool(const unsigned char*)>& row) :
+			row_length(row_length), row(row)
+		{
+			compact_size = std::max(history * 8, history + row_length * 2);
+			data.reserve(compact_size + 258);
+		}
+
+		void put(unsigned char value)
+		{
+			data.push_back(value);
+		}
+
+		// byte by byte, the copy may overlap what it is writing
+		bool copy(size_t distance, int length)
+		{
+			if (distance > data.size())
+			{
+				return false;
+			}
+
+			size_t from = data.size() - distance;
+			for (int i = 0; i < length; i++)
+			{
+				data.push_back(data[from + i]);
+			}
+			return true;
+		}
+
+		bool flush()
+		{
+			return data.size() - start < row_length || drain();
+		}
+
+		bool drain()
+		{
+			while (data.size() - start >= row_length)
+			{
+				if (!row(&data[start]))
+				{
+					return false;
+				}
+				start += row_length;
+			}
+
+			if (data.size() >= compact_size)
+			{
+				size_t drop = std::min(start, data.size() - history);
+				data.erase(data.begin(), data.begin() + drop);
+				start -= drop;
+			}
+			return true;
+		}
+	};
+
+	/**
+	*  A canonical Huffman code, stored as the number of codes of each
+	*  length and the symbols in code order.
+	*/
+	struct Huffman
+	{
+		short count[16];
+		short symbol[288];
+	};
+
+	/**
+	*  Builds a code from its code lengths.
+	*  @return false if the lengths describe more codes than fit.
+	*  Incomplete codes are allowed, as deflate uses them for a
+	*  single distance code.
+	*/
+	bool buildHuffman(Huffman& code, const short* lengths, int n)
+	{
+		memset(code.count, 0, sizeof(code.count));
+		for (int i = 0; i < n; i++)
+		{
+			code.count[lengths[i]]++;
+		}
+
+		int left = 1;
+		for (int len = 1; len < 16; len++)
+		{
+			left <<= 1;
+			left -= code.count[len];
+			if (left < 0)
+			{
+				return false;
+			}
+		}
+
+		short offsets[16];
+		offsets[1] = 0;
+		for (int len = 1; len < 15; len++)
+		{
+			offsets[len + 1] = offsets[len] + code.count[len];
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			if (lengths[i] != 0)
+			{
+				code.symbol[offsets[lengths[i]]++] = static_cast<short>(i);
+			}
+		}
+		return true;
+	}
+
+	int decodeSymbol(BitReader& in, const Huffman& code)
+	{
+		int value = 0;
+		int first = 0;
+		int index = 0;
+		for (int len = 1; len < 16; len++)
+		{
+			value |= in.bits(1);
+			int count = code.count[len];
+			if (value - count < first)
+			{
+				return code.symbol[index + (value - first)];
+			}
+			index += count;
+			first += count;
+			first <<= 1;
+			value <<= 1;
+		}
+		return -1;
+	}
+
+	bool inflateCodes(BitReader& in, InflateWindow& out,
+		const Huffman& lengths, const Huffman& distances)
+	{
+		for (;;)
+		{
+			int symbol = decodeSymbol(in, lengths);
+			if (symbol < 0 || in.overrun)
+			{
+				return false;
+			}
+
+			if (symbol < 256)
+			{
+				out.put(static_cast<unsigned char>(symbol));
+				if (!out.flush())
+				{
+					return false;
+				}
+				continue;
+			}
+
+			if (symbol == 256)
+			{
+				return true;
+			}
+
+			symbol -= 257;
+			if (symbol >= 29)
+			{
+				return false;
+			}
+			int length = length_base[symbol] + in.bits(length_extra[symbol]);
+
+			symbol = decodeSymbol(in, distances);
+			if (symbol < 0 || symbol >= 30)
+			{
+				return false;
+			}
+			size_t distance = distance_base[symbol] + in.bits(distance_extra[symbol]);
+			if (in.overrun || !out.copy(distance, length) || !out.flush())
+			{
+				return false;
+			}
+		}
+	}
+
+	struct FixedCodes
+	{
+		Huffman lengths;
+		Huffman distances;
+
+		FixedCodes()
+		{
+			short code_lengths[288];
+			int i = 0;
+			for (; i < 144; i++) code_lengths[i] = 8;
+			for (; i < 256; i++) code_lengths[i] = 9;
+			for (; i < 280; i++) code_lengths[i] = 7;
+			for (; i < 288; i++) code_lengths[i] = 8;
+			buildHuffman(lengths, code_lengths, 288);
+
+			for (i = 0; i < 30; i++) code_lengths[i] = 5;
+			buildHuffman(distances, code_lengths, 30);
+		}
+	};
+
+	bool inflateFixed(BitReader& in, InflateWindow& out)
+	{
+		static const FixedCodes codes;
+		return inflateCodes(in, out, codes.lengths, codes.distances);
+	}
+
+	bool inflateDynamic(BitReader& in, InflateWindow& out)
+	{
+		static const short order[19] = {
+			16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+		int literal_count = in.bits(5) + 257;
+		int distance_count = in.bits(5) + 1;
+		int length_count = in.bits(4) + 4;
+		if (literal_count > 286 || distance_count > 30)
+		{
+			return false;
+		}
+
+		short code_lengths[320] = {};
+		for (int i = 0; i < length_count; i++)
+		{
+			code_lengths[order[i]] = static_cast<short>(in.bits(3));
+		}
+
+		Huffman length_code;
+		if (!buildHuffman(length_code, code_lengths, 19))
+		{
+			return false;
+		}
+
+		int total = literal_count + distance_count;
+		for (int i = 0; i < total;)
+		{
+			int symbol = decodeSymbol(in, length_code);
+			if (symbol < 0 || in.overrun)
+			{
+				return false;
+			}
+
+			if (symbol < 16)
+			{
+				code_lengths[i++] = static_cast<short>(symbol);
+				continue;
+			}
+
+			short repeat_length = 0;
+			int repeat = 0;
+			if (symbol == 16)
+			{
+				if (i == 0)
+				{
+					return false;
+				}
+				repeat_length = code_lengths[i - 1];
+				repeat = 3 + in.bits(2);
+			}
+			else if (symbol == 17)
+			{
+				repeat = 3 + in.bits(3);
+			}
+			else
+			{
+				repeat = 11 + in.bits(7);
+			}
+
+			if (i + repeat > total)
+			{
+				return false;
+			}
+			while (repeat--)
+			{
+				code_lengths[i++] = repeat_length;
+			}
+		}
+
+		if (code_lengths[256] == 0)
+		{
+			return false;
+		}
+
+		Huffman lengths;
+		Huffman distances;
+		if (!buildHuffman(lengths, code_lengths, literal_count) ||
+			!buildHuffman(distances, code_lengths + literal_count, distance_count))
+		{
+			return false;
+		}
+
+		return inflateCodes(in, out, lengths, distances);
+	}
+
+	/**
+	*  Inflates a zlib stream into a window.
+	*/
+	bool inflateZlib(BitReader& in, InflateWindow& out)
+	{
+		int method = in.byte();
+		int flags = in.byte();
+		if (in.overrun || (method & 0x0f) != 8 || ((method << 8) | flags) % 31 != 0 ||
+			(flags & 0x20))
+		{
+			return false;
+		}
+
+		int last = 0;
+		while (!last)
+		{
+			last = in.bits(1);
+			int type = in.bits(2);
+			bool ok = false;
+			if (type == 0)
+			{
+				// stored, starts on a byte boundary
+				in.buffer = 0;
+				in.count = 0;
+				size_t length = in.byte();
+				length |= in.byte() << 8;
+				size_t check = in.byte();
+				check |= in.byte() << 8;
+				if (in.overrun || length != (~check & 0xffff))
+				{
+					return false;
+				}
+
+				while (length > 0 && in.refill())
+				{
+					size_t run = std::min(length, in.size - in.pos);
+					out.data.insert(out.data.end(), in.data + in.pos, in.data + in.pos + run);
+					in.pos += run;
+					length -= run;
+				}
+				ok = length == 0 && out.flush();
+			}
+			else if (type == 1)
+			{
+				ok = inflateFixed(in, out);
+			}
+			else if (type == 2)
+			{
+				ok = inflateDynamic(in, out);
+			}
+
+			if (!ok || in.overrun)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	int paeth(int a, int b, int c)
+	{
+		int p = a + b - c;
+		int pa = p > a ? p - a : a - p;
+		int pb = p > b ? p - b : b - p;
+		int pc = p > c ? p - c : c - p;
+		if (pa <= pb && pa <= pc)
+		{
+			return a;
+		}
+		return pb <= pc ? b : c;
+	}
+
+#ifdef PNG_SSE2
+	// the pixel size is a constant so these compile to single moves
+	template <size_t bpp>
+	__m128i loadPixel(const unsigned char* p)
+	{
+		int value = 0;
+		memcpy(&value, p, bpp);
+		return _mm_cvtsi32_si128(value);
+	}
+
+	template <size_t bpp>
+	void storePixel(unsigned char* p, __m128i pixel)
+	{
+		int value = _mm_cvtsi128_si32(pixel);
+		memcpy(p, &value, bpp);
+	}
+
+	__m128i select(__m128i mask, __m128i if_set, __m128i if_clear)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_clear));
+	}
+
+	/**
+	*  Sub, Average and Paeth for 3 and 4 byte pixels.
+	*  Each pixel depends on the one to its left, so these work a pixel
+	*  at a time, with every channel of the pixel in one register.
+	*/
+	template <size_t bpp>
+	void unfilterPixelsSSE2(int filter, const unsigned char* filtered, unsigned char* row,
+		const unsigned char* prior, size_t length)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i left = zero;
+		switch (filter)
+		{
+		case 1:
+			for (size_t i = 0; i < length; i += bpp)
+			{
+				left = _mm_add_epi8(left, loadPixel<bpp>(filtered + i));
+				storePixel<bpp>(row + i, left);
+			}
+			break;
+
+		case 3:
+		{
+			// avg_epu8 rounds up, the filter rounds down
+			const __m128i one = _mm_set1_epi8(1);
+			for (size_t i = 0; i < length; i += bpp)
+			{
+				__m128i up = loadPixel<bpp>(prior + i);
+				__m128i average = _mm_sub_epi8(_mm_avg_epu8(left, up),
+					_mm_and_si128(_mm_xor_si128(left, up), one));
+				left = _mm_add_epi8(loadPixel<bpp>(filtered + i), average);
+				storePixel<bpp>(row + i, left);
+			}
+			break;
+		}
+
+		default:
+		{
+			// 16 bit lanes, so the distances can't overflow
+			__m128i upper_left = zero;
+			const __m128i low_byte = _mm_set1_epi16(0xff);
+			for (size_t i = 0; i < length; i += bpp)
+			{
+				__m128i up = _mm_unpacklo_epi8(loadPixel<bpp>(prior + i), zero);
+				__m128i to_left = _mm_sub_epi16(up, upper_left);
+				__m128i to_up = _mm_sub_epi16(left, upper_left);
+				__m128i to_upper_left = _mm_add_epi16(to_left, to_up);
+				to_left = _mm_max_epi16(to_left, _mm_sub_epi16(zero, to_left));
+				to_up = _mm_max_epi16(to_up, _mm_sub_epi16(zero, to_up));
+				to_upper_left = _mm_max_epi16(to_upper_left, _mm_sub_epi16(zero, to_upper_left));
+
+				// ties go to left, then up, as in paeth()
+				__m128i nearest = _mm_min_epi16(to_upper_left, _mm_min_epi16(to_left, to_up));
+				__m128i predicted = select(_mm_cmpeq_epi16(to_up, nearest), up, upper_left);
+				predicted = select(_mm_cmpeq_epi16(to_left, nearest), left, predicted);
+
+				__m128i value = _mm_unpacklo_epi8(loadPixel<bpp>(filtered + i), zero);
+				left = _mm_and_si128(_mm_add_epi16(value, predicted), low_byte);
+				upper_left = up;
+				storePixel<bpp>(row + i, _mm_packus_epi16(left, left));
+			}
+			break;
+		}
+		}
+	}
+#endif
+
+	/**
+	*  Reverses the filter on one row.
+	*  @param [in] filtered The row as inflated, without its filter byte.
+	*  @param [out] row Where the unfiltered row is written.
+	*  @param [in] prior The unfiltered row above, all zero for the first.
+	*/
+	bool unfilterRow(int filter, const unsigned char* filtered, unsigned char* row,
+		const unsigned char* prior, size_t length, size_t bpp)
+	{
+#ifdef PNG_SSE2
+		if ((filter == 1 || filter == 3 || filter == 4) && (bpp == 3 || bpp == 4))
+		{
+			if (bpp == 4)
+			{
+				unfilterPixelsSSE2<4>(filter, filtered, row, prior, length);
+			}
+			else
+			{
+				unfilterPixelsSSE2<3>(filter, filtered, row, prior, length);
+			}
+			return true;
+		}
+#endif
+
+		switch (filter)
+		{
+		case 0:
+			memcpy(row, filtered, length);
+			return true;
+
+		case 1:
+			for (size_t i = 0; i < length; i++)
+			{
+				int left = i >= bpp ? row[i - bpp] : 0;
+				row[i] = static_cast<unsigned char>(filtered[i] + left);
+			}
+			return true;
+
+		case 2:
+		{
+			size_t i = 0;
+#ifdef PNG_SSE2
+			for (; i + 16 <= length; i += 16)
+			{
+				__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(filtered + i));
+				__m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prior + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_add_epi8(value, up));
+			}
+#endif
+			for (; i < length; i++)
+			{
+				row[i] = static_cast<unsigned char>(filtered[i] + prior[i]);
+			}
+			return true;
+		}
+
+		case 3:
+			for (size_t i = 0; i < length; i++)
+			{
+				int left = i >= bpp ? row[i - bpp] : 0;
+				row[i] = static_cast<unsigned char>(filtered[i] + ((left + prior[i]) >> 1));
+			}
+			return true;
+
+		case 4:
+			for (size_t i = 0; i < length; i++)
+			{
+				int left = i >= bpp ? row[i - bpp] : 0;
+				int upper_left = i >= bpp ? prior[i - bpp] : 0;
+				row[i] = static_cast<unsigned char>(filtered[i] + paeth(left, prior[i], upper_left));
+			}
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	/**
+	*  Scales each colour of a row of RGBA pixels by its alpha.
+	*/
+	void premultiplyRow(unsigned char* row, int width)
+	{
+		for (int x = 0; x < width; x++, row += 4)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				// divides by 255 with rounding
+				int scaled = row[c] * row[3] + 128;
+				row[c] = static_cast<unsigned char>((scaled + (scaled >> 8)) >> 8);
+			}
+		}
+	}
+
+	/**
+	*  Reads one sample from an unfiltered row, scaled to 8 bits.
+	*/
+	int sample(const unsigned char* row, int index, int depth, bool scale)
+	{
+		switch (depth)
+		{
+		case 16:
+			return row[index * 2];
+
+		case 8:
+			return row[index];
+
+		default:
+		{
+			int per_byte = 8 / depth;
+			int shift = 8 - depth * (index % per_byte + 1);
+			int value = (row[index / per_byte] >> shift) & ((1 << depth) - 1);
+			return scale ? value * 255 / ((1 << depth) - 1) : value;
+		}
+		}
+	}
+
+	/**
+	*  Sets one filter type for a row and writes it into out, returning
+	*  the sum of the residuals as signed bytes.
+	*/
+	unsigned filterRow(int filter, const unsigned char* row, const unsigned char* prior,
+		size_t length, unsigned char* out)
+	{
+		const size_t bpp = 4;
+		unsigned cost = 0;
+		for (size_t i = 0; i < length; i++)
+		{
+			int left = i >= bpp ? row[i - bpp] : 0;
+			int up = prior ? prior[i] : 0;
+			int upper_left = prior && i >= bpp ? prior[i - bpp] : 0;
+			int predicted = 0;
+			switch (filter)
+			{
+			case 1: predicted = left; break;
+			case 2: predicted = up; break;
+			case 3: predicted = (left + up) >> 1; break;
+			case 4: predicted = paeth(left, up, upper_left); break;
+			default: break;
+			}
+
+			unsigned char residual = static_cast<unsigned char>(row[i] - predicted);
+			out[i] = residual;
+			cost += residual < 128 ? residual : 256 - residual;
+		}
+		return cost;
+	}
+
+	/**
+	*  Writes a deflate stream a bit at a time, lowest bit first.
+	*/
+	struct BitWriter
+	{
+		std::vector<unsigned char>& out;
+		uint32_t buffer = 0;
+		int      count = 0;
+
+		explicit BitWriter(std::vector<unsigned char>& out) : out(out) {}
+
+		void put(uint32_t value, int bits)
+		{
+			buffer |= value << count;
+			count += bits;
+			while (count >= 8)
+			{
+				out.push_back(static_cast<unsigned char>(buffer));
+				buffer >>= 8;
+				count -= 8;
+			}
+		}
+
+		// Huffman codes are packed starting from their top bit
+		void putCode(uint32_t code, int bits)
+		{
+			uint32_t reversed = 0;
+			for (int i = 0; i < bits; i++)
+			{
+				reversed = (reversed << 1) | ((code >> i) & 1);
+			}
+			put(reversed, bits);
+		}
+
+		void flush()
+		{
+			if (count > 0)
+			{
+				out.push_back(static_cast<unsigned char>(buffer));
+			}
+			buffer = 0;
+			count = 0;
+		}
+	};
+
+	void putLiteral(BitWriter& bits, int symbol)
+	{
+		if (symbol < 144)
+		{
+			bits.putCode(0x30 + symbol, 8);
+		}
+		else if (symbol < 256)
+		{
+			bits.putCode(0x190 + symbol - 144, 9);
+		}
+		else if (symbol < 280)
+		{
+			bits.putCode(symbol - 256, 7);
+		}
+		else
+		{
+			bits.putCode(0xc0 + symbol - 280, 8);
+		}
+	}
+
+	void putMatch(BitWriter& bits, int length, int distance)
+	{
+		int code = 28;
+		while (length_base[code] > length)
+		{
+			code--;
+		}
+		putLiteral(bits, 257 + code);
+		bits.put(length - length_base[code], length_extra[code]);
+
+		code = 29;
+		while (distance_base[code] > distance)
+		{
+			code--;
+		}
+		bits.putCode(code, 5);
+		bits.put(distance - distance_base[code], distance_extra[code]);
+	}
+
+	/**
+	*  Deflates into a zlib stream as one block of fixed Huffman codes.
+	*  Matches are found with hash chains over the last 32K, taking
+	*  the longest of the first few candidates.
+	*/
+	void deflateZlib(const unsigned char* data, size_t size, std::vector<unsigned char>& out)
+	{
+		const int window = 32768;
+		const int hash_size = 1 << 15;
+		const int max_chain = 64;
+		const int max_match = 258;
+
+		out.push_back(0x78);
+		out.push_back(0x01);
+
+		BitWriter bits(out);
+		bits.put(1, 1);   // the last block
+		bits.put(1, 2);   // fixed codes
+
+		std::vector<int> head(hash_size, -1);
+		std::vector<int> prev(window, -1);
+		auto hash = [data](size_t i)
+		{
+			return ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & (hash_size - 1);
+		};
+		auto insert = [&](size_t i)
+		{
+			if (i + 2 < size)
+			{
+				int h = hash(i);
+				prev[i % window] = head[h];
+				head[h] = static_cast<int>(i);
+			}
+		};
+
+		size_t i = 0;
+		while (i < size)
+		{
+			int best_length = 0;
+			int best_distance = 0;
+			if (i + 2 < size)
+			{
+				int limit = static_cast<int>(size - i < max_match ? size - i : max_match);
+				int candidate = head[hash(i)];
+				for (int chain = 0; candidate >= 0 && chain < max_chain; chain++)
+				{
+					int distance = static_cast<int>(i) - candidate;
+					if (distance > window)
+					{
+						break;
+					}
+
+					int length = 0;
+					while (length < limit && data[candidate + length] == data[i + length])
+					{
+						length++;
+					}
+					if (length > best_length)
+					{
+						best_length = length;
+						best_distance = distance;
+						if (length == limit)
+						{
+							break;
+						}
+					}
+					candidate = prev[candidate % window];
+				}
+			}
+
+			if (best_length >= 3)
+			{
+				putMatch(bits, best_length, best_distance);
+				for (int k = 0; k < best_length; k++)
+				{
+					insert(i + k);
+				}
+				i += best_length;
+			}
+			else
+			{
+				putLiteral(bits, data[i]);
+				insert(i);
+				i++;
+			}
+		}
+
+		putLiteral(bits, 256);
+		bits.flush();
+		writeBE32(out, adler32(data, size));
+	}
+
+	void writeChunk(std::vector<unsigned char>& out, const char* type,
+		const unsigned char* data, size_t size)
+	{
+		writeBE32(out, static_cast<uint32_t>(size));
+		size_t start = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data, data + size);
+		writeBE32(out, crc32(&out[start], size + 4));
+	}
+
+	bool readFile(const std::string& path, std::vector<unsigned char>& data)
+	{
+		FILE* file = fopen(path.c_str(), "rb");
+		if (!file)
+		{
+			return false;
+		}
+
+		// one read into a buffer of the file's size
+		long size = -1;
+		if (fseek(file, 0, SEEK_END) == 0)
+		{
+			size = ftell(file);
+		}
+
+		bool ok = size >= 0 && fseek(file, 0, SEEK_SET) == 0;
+		if (ok)
+		{
+			data.resize(static_cast<size_t>(size));
+			ok = fread(data.data(), 1, data.size(), file) == data.size();
+		}
+
+		fclose(file);
+		return ok;
+	}
+}
+
+/**
+*   @brief   Decodes a PNG
+*   @details The chunks are walked checking each CRC, then the IDAT
+			 data is inflated where it lies. Each row is unfiltered
+			 as soon as it has been inflated, so only the last 32K of
+			 inflated data is held. 8-bit RGBA rows are unfiltered
+			 straight into the image, others into a scanline that is
+			 then expanded to RGBA. Palette and grey images take
+			 their alpha from tRNS when it's present.
+*   @return  False on any malformed or unsupported input.
+*/
+bool decodePng(const unsigned char* data, size_t size, Image& image, bool premultiply)
+{
+	if (size < 8 || memcmp(data, png_signature, 8) != 0)
+	{
+		return false;
+	}
+
+	int width = 0;
+	int height = 0;
+	int depth = 0;
+	int colour_type = -1;
+	std::vector<ByteRange> compressed;
+	unsigned char palette[256][4];
+	int palette_size = 0;
+	int transparent[3] = { -1, -1, -1 };
+
+	for (int i = 0; i < 256; i++)
+	{
+		palette[i][0] = palette[i][1] = palette[i][2] = 0;
+		palette[i][3] = 255;
+	}
+
+	size_t pos = 8;
+	bool ended = false;
+	while (!ended && pos + 12 <= size)
+	{
+		uint32_t length = readBE32(data + pos);
+		const unsigned char* type = data + pos + 4;
+		const unsigned char* body = data + pos + 8;
+		if (length > size - pos - 12 ||
+			crc32(type, length + 4) != readBE32(body + length))
+		{
+			return false;
+		}
+
+		if (!memcmp(type, "IHDR", 4) && length == 13)
+		{
+			width = static_cast<int>(readBE32(body));
+			height = static_cast<int>(readBE32(body + 4));
+			depth = body[8];
+			colour_type = body[9];
+			if (body[10] != 0 || body[11] != 0 || body[12] != 0 ||
+				width <= 0 || height <= 0 || width > 1 << 24 || height > 1 << 24)
+			{
+				return false;
+			}
+		}
+		else if (!memcmp(type, "PLTE", 4))
+		{
+			palette_size = static_cast<int>(length / 3 < 256 ? length / 3 : 256);
+			for (int i = 0; i < palette_size; i++)
+			{
+				palette[i][0] = body[i * 3];
+				palette[i][1] = body[i * 3 + 1];
+				palette[i][2] = body[i * 3 + 2];
+			}
+		}
+		else if (!memcmp(type, "tRNS", 4))
+		{
+			if (colour_type == 3)
+			{
+				for (uint32_t i = 0; i < length && i < 256; i++)
+				{
+					palette[i][3] = body[i];
+				}
+			}
+			else if (colour_type == 0 && length >= 2)
+			{
+				transparent[0] = (body[0] << 8) | body[1];
+			}
+			else if (colour_type == 2 && length >= 6)
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					transparent[c] = (body[c * 2] << 8) | body[c * 2 + 1];
+				}
+			}
+		}
+		else if (!memcmp(type, "IDAT", 4))
+		{
+			compressed.push_back({ body, length });
+		}
+		else if (!memcmp(type, "IEND", 4))
+		{
+			ended = true;
+		}
+
+		pos += length + 12;
+	}
+
+	int channels;
+	switch (colour_type)
+	{
+	case 0: channels = 1; break;
+	case 2: channels = 3; break;
+	case 3: channels = 1; break;
+	case 4: channels = 2; break;
+	case 6: channels = 4; break;
+	default: return false;
+	}
+
+	bool depth_ok = depth == 8 || (depth == 16 && colour_type != 3) ||
+		((depth == 1 || depth == 2 || depth == 4) && (colour_type == 0 || colour_type == 3));
+	if (!depth_ok || (colour_type == 3 && palette_size == 0))
+	{
+		return false;
+	}
+
+	size_t bits_per_pixel = static_cast<size_t>(channels) * depth;
+	size_t stride = (bits_per_pixel * width + 7) / 8;
+	size_t bpp = bits_per_pixel >= 8 ? bits_per_pixel / 8 : 1;
+	bool direct = colour_type == 6 && depth == 8;
+
+	// a corrupt header can claim any size, so check it against the
+	// data that could fill it before allocating
+	size_t compressed_size = 0;
+	for (const ByteRange& range : compressed)
+	{
+		compressed_size += range.size;
+	}
+
+	size_t inflated_size = (stride + 1) * height;
+	if (static_cast<size_t>(width) * height > max_pixels ||
+		inflated_size > (compressed_size + 1) * max_inflate_ratio)
+	{
+		return false;
+	}
+
+	std::vector<unsigned char> zero_row;
+	std::vector<unsigned char> scanlines;
+	try
+	{
+		image.resize(width, height);
+		zero_row.assign(stride, 0);
+		scanlines.assign(direct ? 0 : stride * 2, 0);
+	}
+	catch (const std::bad_alloc&)
+	{
+		image = Image();
+		return false;
+	}
+
+	int y = 0;
+	auto unfilter = [&](const unsigned char* filtered)
+	{
+		// anything after the last row is ignored
+		if (y == height)
+		{
+			return true;
+		}
+
+		unsigned char* row = direct ? image.pixel(0, y) : &scanlines[(y & 1) * stride];
+		const unsigned char* prior = y == 0 ? zero_row.data() :
+			direct ? image.pixel(0, y - 1) : &scanlines[((y + 1) & 1) * stride];
+		if (!unfilterRow(filtered[0], filtered + 1, row, prior, stride, bpp))
+		{
+			return false;
+		}
+
+		if (direct)
+		{
+			// the row above is only finished with once this one is unfiltered
+			if (premultiply && y > 0)
+			{
+				premultiplyRow(image.pixel(0, y - 1), width);
+			}
+			y++;
+			return true;
+		}
+
+		// 16-bit transparency is compared at full depth before scaling
+		auto full = [row, depth](int index)
+		{
+			return depth == 16 ? (row[index * 2] << 8) | row[index * 2 + 1] :
+				sample(row, index, depth, false);
+		};
+
+		unsigned char* out = image.pixel(0, y);
+		for (int x = 0; x < width; x++, out += 4)
+		{
+			switch (colour_type)
+			{
+			case 0:
+			{
+				int grey = sample(row, x, depth, true);
+				out[0] = out[1] = out[2] = static_cast<unsigned char>(grey);
+				out[3] = full(x) == transparent[0] ? 0 : 255;
+				break;
+			}
+			case 2:
+				for (int c = 0; c < 3; c++)
+				{
+					out[c] = static_cast<unsigned char>(sample(row, x * 3 + c, depth, true));
+				}
+				out[3] = full(x * 3) == transparent[0] && full(x * 3 + 1) == transparent[1] &&
+					full(x * 3 + 2) == transparent[2] ? 0 : 255;
+				break;
+			case 3:
+				memcpy(out, palette[sample(row, x, depth, false)], 4);
+				break;
+			case 4:
+				out[0] = out[1] = out[2] = static_cast<unsigned char>(sample(row, x * 2, depth, true));
+				out[3] = static_cast<unsigned char>(sample(row, x * 2 + 1, depth, true));
+				break;
+			default:
+				for (int c = 0; c < 4; c++)
+				{
+					out[c] = static_cast<unsigned char>(sample(row, x * 4 + c, depth, true));
+				}
+				break;
+			}
+		}
+
+		if (premultiply)
+		{
+			premultiplyRow(image.pixel(0, y), width);
+		}
+		y++;
+		return true;
+	};
+
+	BitReader in(compressed);
+	InflateWindow window(stride + 1, unfilter);
+	if (!inflateZlib(in, window) || !window.drain() || y < height)
+	{
+		return false;
+	}
+
+	if (direct && premultiply)
+	{
+		premultiplyRow(image.pixel(0, height - 1), width);
+	}
+	return true;
+}
+
+bool loadPng(const std::string& path, Image& image, bool premultiply)
+{
+	std::vector<unsigned char> data;
+	return readFile(path, data) && decodePng(data.data(), data.size(), image, premultiply);
+}
+
+/**
+*   @brief   Encodes an image as a PNG
+*   @details Each row is tried with all five filters and the one with
+			 the smallest total residual is kept, the usual heuristic
+			 for picking filters cheaply.
+*   @return  void
+*/
+void encodePng(const Image& image, std::vector<unsigned char>& out)
+{
+	size_t stride = static_cast<size_t>(image.width) * 4;
+	std::vector<unsigned char> filtered((stride + 1) * image.height);
+	std::vector<unsigned char> trial(stride);
+	for (int y = 0; y < image.height; y++)
+	{
+		const unsigned char* row = image.pixel(0, y);
+		const unsigned char* prior = y > 0 ? image.pixel(0, y - 1) : nullptr;
+		unsigned char* dest = &filtered[static_cast<size_t>(y) * (stride + 1)];
+
+		unsigned best_cost = 0xffffffff;
+		for (int filter = 0; filter < 5; filter++)
+		{
+			unsigned cost = filterRow(filter, row, prior, stride, trial.data());
+			if (cost < best_cost)
+			{
+				best_cost = cost;
+				dest[0] = static_cast<unsigned char>(filter);
+				memcpy(dest + 1, trial.data(), stride);
+			}
+		}
+	}
+
+	out.clear();
+	out.insert(out.end(), png_signature, png_signature + 8);
+
+	unsigned char header[13];
+	header[0] = static_cast<unsigned char>(image.width >> 24);
+	header[1] = static_cast<unsigned char>(image.width >> 16);
+	header[2] = static_cast<unsigned char>(image.width >> 8);
+	header[3] = static_cast<unsigned char>(image.width);
+	header[4] = static_cast<unsigned char>(image.height >> 24);
+	header[5] = static_cast<unsigned char>(image.height >> 16);
+	header[6] = static_cast<unsigned char>(image.height >> 8);
+	header[7] = static_cast<unsigned char>(image.height);
+	header[8] = 8;    // bit depth
+	header[9] = 6;    // RGBA
+	header[10] = 0;
+	header[11] = 0;
+	header[12] = 0;
+	writeChunk(out, "IHDR", header, sizeof(header));
+
+	std::vector<unsigned char> compressed;
+	deflateZlib(filtered.data(), filtered.size(), compressed);
+	writeChunk(out, "IDAT", compressed.data(), compressed.size());
+	writeChunk(out, "IEND", nullptr, 0);
+}
+
+bool savePng(const std::string& path, const Image& image)
+{
+	std::vector<unsigned char> data;
+	encodePng(image, data);
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+	return fclose(file) == 0 && written;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/**
+*  An 8-bit RGBA image held in memory.
+*  Rows are packed top to bottom with no padding, four bytes a pixel.
+*/
+struct Image
+{
+	int width = 0;
+	int height = 0;
+	std::vector<unsigned char> pixels;
+
+	/**
+	*  Resizes the image, clearing every pixel to transparent black.
+	*/
+	void resize(int new_width, int new_height);
+
+	unsigned char*       pixel(int x, int y)       { return &pixels[(static_cast<size_t>(y) * width + x) * 4]; }
+	const unsigned char* pixel(int x, int y) const { return &pixels[(static_cast<size_t>(y) * width + x) * 4]; }
+};
+
+/**
+*  Decodes a PNG held in memory.
+*  Every colour type and bit depth is accepted and converted to 8-bit
+*  RGBA, 16-bit samples keep their high byte. Interlaced images are
+*  not supported. The image is inflated and unfiltered a row at a
+*  time, so besides the image itself only a small window is held.
+*  @param [in] data The contents of the file.
+*  @param [in] size The size of the file in bytes.
+*  @param [out] image The decoded image.
+*  @param [in] premultiply Scales each colour by its alpha as the
+*  rows are written.
+*  @return false if the data isn't a PNG this can read, or its header
+*  claims more pixels than the data could fill or than 2^26.
+*/
+bool decodePng(const unsigned char* data, size_t size, Image& image, bool premultiply = false);
+
+/**
+*  Reads and decodes a PNG file.
+*/
+bool loadPng(const std::string& path, Image& image, bool premultiply = false);
+
+/**
+*  Encodes an image as an 8-bit RGBA PNG.
+*  Each row gets whichever filter leaves the smallest residuals, and
+*  the data is deflated with the fixed Huffman codes.
+*  @param [out] out The contents of the file.
+*/
+void encodePng(const Image& image, std::vector<unsigned char>& out);
+
+/**
+*  Encodes an image and writes it to a file.
+*/
+bool savePng(const std::string& path, const Image& image);
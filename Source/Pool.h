@@ -0,0 +1,194 @@
+#pragma once
+#include <stdint.h>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+*  Refers to an object in a Pool.
+*  A slot's generation is bumped every time its object is released,
+*  so a handle kept after its object is gone no longer matches and
+*  the pool reports it as stale rather than handing out whatever
+*  has been built in the slot since. A default handle is never valid.
+*/
+template <typename T>
+struct PoolHandle
+{
+	uint32_t index = 0;
+	uint32_t generation = 0;
+
+	bool operator==(const PoolHandle& rhs) const
+	{
+		return index == rhs.index && generation == rhs.generation;
+	}
+
+	bool operator!=(const PoolHandle& rhs) const { return !(*this == rhs); }
+};
+
+/**
+*  Fixed size slabs of objects of one type.
+*  Objects are built in place in contiguous slabs, which are never
+*  moved or freed until the pool is, so pointers stay valid until the
+*  object is released. Free slots are kept in a list threaded through
+*  the slots themselves, so acquire and release are O(1) and only
+*  reach the global allocator when every slab is full.
+*/
+template <typename T>
+class Pool
+{
+public:
+	typedef PoolHandle<T> Handle;
+
+	/**
+	*  @param [in] slab_size How many objects each slab holds.
+	*/
+	explicit Pool(int slab_size = 64) : slab_size(slab_size > 0 ? slab_size : 1) {}
+
+	~Pool()
+	{
+		for (uint32_t i = 0; i < slot_count; i++)
+		{
+			Slot& s = slot(i);
+			if (s.alive)
+			{
+				object(s)->~T();
+			}
+		}
+	}
+
+	Pool(const Pool&) = delete;
+	Pool& operator=(const Pool&) = delete;
+
+	/**
+	*  Builds an object in a free slot, adding a slab if there are none.
+	*  @param [in] args Passed on to T's constructor.
+	*  @return a handle to the new object.
+	*/
+	template <typename... Args>
+	Handle acquire(Args&&... args)
+	{
+		if (free_head == no_slot)
+		{
+			addSlab();
+		}
+
+		uint32_t index = free_head;
+		Slot& s = slot(index);
+		new (&s.storage) T(std::forward<Args>(args)...);
+		free_head = s.next_free;
+		s.alive = true;
+		live_count++;
+
+		Handle handle;
+		handle.index = index;
+		handle.generation = s.generation;
+		return handle;
+	}
+
+	/**
+	*  Destroys an object and returns its slot to the free list.
+	*  Stale and default handles are ignored.
+	*/
+	void release(Handle handle)
+	{
+		if (!isValid(handle))
+		{
+			return;
+		}
+
+		Slot& s = slot(handle.index);
+		object(s)->~T();
+		s.alive = false;
+		s.generation = nextGeneration(s.generation);
+		s.next_free = free_head;
+		free_head = handle.index;
+		live_count--;
+	}
+
+	/**
+	*  Looks up an object.
+	*  @return the object, or nullptr if the handle is stale.
+	*/
+	T* get(Handle handle)
+	{
+		return isValid(handle) ? object(slot(handle.index)) : nullptr;
+	}
+
+	const T* get(Handle handle) const
+	{
+		return isValid(handle) ? object(slot(handle.index)) : nullptr;
+	}
+
+	bool isValid(Handle handle) const
+	{
+		if (handle.index >= slot_count)
+		{
+			return false;
+		}
+
+		const Slot& s = slot(handle.index);
+		return s.alive && s.generation == handle.generation;
+	}
+
+	/**
+	*  The generation a slot moves to when its object is released.
+	*  After 2^32 - 1 releases it wraps back to 1, skipping 0 so that
+	*  a default handle can never match a slot.
+	*/
+	static uint32_t nextGeneration(uint32_t generation)
+	{
+		return generation + 1 ? generation + 1 : 1;
+	}
+
+	int size() const { return static_cast<int>(live_count); }
+	int capacity() const { return static_cast<int>(slot_count); }
+
+private:
+	static const uint32_t no_slot = 0xffffffff;
+
+	struct Slot
+	{
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+		uint32_t generation = 1;
+		uint32_t next_free = no_slot;
+		bool     alive = false;
+	};
+
+	Slot& slot(uint32_t index)
+	{
+		return slabs[index / slab_size][index % slab_size];
+	}
+
+	const Slot& slot(uint32_t index) const
+	{
+		return slabs[index / slab_size][index % slab_size];
+	}
+
+	static T* object(Slot& s) { return reinterpret_cast<T*>(&s.storage); }
+	static const T* object(const Slot& s) { return reinterpret_cast<const T*>(&s.storage); }
+
+	/**
+	*  Adds a slab and threads its slots onto the free list in order,
+	*  so objects are handed out front to back.
+	*/
+	void addSlab()
+	{
+		slabs.emplace_back(new Slot[slab_size]);
+		Slot* slab = slabs.back().get();
+		for (uint32_t i = 0; i < slab_size; i++)
+		{
+			slab[i].next_free = i + 1 < slab_size ? slot_count + i + 1 : free_head;
+		}
+
+		free_head = slot_count;
+		slot_count += slab_size;
+	}
+
+	std::vector<std::unique_ptr<Slot[]>> slabs;
+	uint32_t slab_size;
+	uint32_t slot_count = 0;
+	uint32_t live_count = 0;
+	uint32_t free_head = no_slot;
+};
@@ -6,7 +6,7 @@
              provided reside within the area of the rectangle.
 *   @return  True if they do.
 */
-bool rect::isInside(float x, float y) const
+bool rect::isInside(real x, real y) const
 {
 	if (x >= this->x &&
 		x <= this->x + this->length)
@@ -47,7 +47,7 @@ bool rect::isInside(const rect& rhs) const
              check to see if the value falls inside it's range.
 *   @return  True if they do.
 */
-bool rect::isBetween(float value, float min, float max) const
+bool rect::isBetween(real value, real min, real max) const
 {
 	return (value >= min) && (value <= max);
 }
\ No newline at end of file
@@ -1,11 +1,13 @@
 #pragma once
+#include "Scalar.h"
+
 struct rect
 {
-	float x = 0;
-	float y = 0;
-	float length = 0;
-	float height = 0;
-	bool  isInside(float x, float y) const;
+	real x = 0;
+	real y = 0;
+	real length = 0;
+	real height = 0;
+	bool  isInside(real x, real y) const;
 	bool  isInside(const rect& rhs) const;
-	bool  isBetween(float value, float min, float max) const;
+	bool  isBetween(real value, real min, real max) const;
 };
\ No newline at end of file
@@ -0,0 +1,306 @@
+#include <string.h>
+#include "RectBatch.h"
+
+// the vector kernels work on floats, fixed-point builds use the scalar loop
+#if !defined(BREAKOUT_FIXED_POINT) && \
+	(defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__))
+#define RECT_BATCH_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define RECT_BATCH_AVX2
+#else
+#include <cpuid.h>
+#define RECT_BATCH_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+typedef int(*overlap_kernel)(const rect&, const rect_batch&, uint64_t*, bool);
+
+/**
+*   @brief   Scalar overlap test for a range of the batch.
+*   @details Stops at the first hit when first_only is set, in which
+			 case the index of the hit is returned instead of a count.
+*   @return  The number of hits, or the first hit index.
+*/
+static int overlapScalar(const rect& r, const rect_batch& b,
+	int begin, uint64_t* mask, bool first_only)
+{
+	int hits = 0;
+	for (int i = begin; i < b.count; i++)
+	{
+		bool overlap =
+			r.x <= b.x[i] + b.length[i] && b.x[i] <= r.x + r.length &&
+			r.y <= b.y[i] + b.height[i] && b.y[i] <= r.y + r.height;
+
+		if (!overlap)
+		{
+			continue;
+		}
+
+		if (first_only)
+		{
+			return i;
+		}
+
+		mask[i >> 6] |= uint64_t(1) << (i & 63);
+		hits++;
+	}
+
+	return first_only ? -1 : hits;
+}
+
+static int kernelScalar(const rect& r, const rect_batch& b,
+	uint64_t* mask, bool first_only)
+{
+	return overlapScalar(r, b, 0, mask, first_only);
+}
+
+#ifdef RECT_BATCH_X86
+
+/**
+*   @brief   Writes a lane mask into the output bitset.
+*   @return  The number of bits that were set.
+*/
+static int storeLanes(uint64_t* mask, int i, unsigned int lanes)
+{
+	mask[i >> 6] |= uint64_t(lanes) << (i & 63);
+
+	int hits = 0;
+	for (; lanes; lanes &= lanes - 1)
+	{
+		hits++;
+	}
+
+	return hits;
+}
+
+static int lowestLane(unsigned int lanes)
+{
+	int lane = 0;
+	while (!(lanes & 1))
+	{
+		lanes >>= 1;
+		lane++;
+	}
+
+	return lane;
+}
+
+static int kernelSSE2(const rect& r, const rect_batch& b,
+	uint64_t* mask, bool first_only)
+{
+	const __m128 min_x = _mm_set1_ps(r.x);
+	const __m128 min_y = _mm_set1_ps(r.y);
+	const __m128 max_x = _mm_set1_ps(r.x + r.length);
+	const __m128 max_y = _mm_set1_ps(r.y + r.height);
+
+	int hits = 0;
+	int i = 0;
+	for (; i + 4 <= b.count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(b.x + i);
+		__m128 y = _mm_loadu_ps(b.y + i);
+		__m128 x2 = _mm_add_ps(x, _mm_loadu_ps(b.length + i));
+		__m128 y2 = _mm_add_ps(y, _mm_loadu_ps(b.height + i));
+
+		__m128 overlap = _mm_and_ps(
+			_mm_and_ps(_mm_cmple_ps(min_x, x2), _mm_cmple_ps(x, max_x)),
+			_mm_and_ps(_mm_cmple_ps(min_y, y2), _mm_cmple_ps(y, max_y)));
+
+		unsigned int lanes = static_cast<unsigned int>(_mm_movemask_ps(overlap));
+		if (!lanes)
+		{
+			continue;
+		}
+
+		if (first_only)
+		{
+			return i + lowestLane(lanes);
+		}
+
+		hits += storeLanes(mask, i, lanes);
+	}
+
+	int tail = overlapScalar(r, b, i, mask, first_only);
+	return first_only ? tail : hits + tail;
+}
+
+RECT_BATCH_AVX2 static int kernelAVX2(const rect& r, const rect_batch& b,
+	uint64_t* mask, bool first_only)
+{
+	const __m256 min_x = _mm256_set1_ps(r.x);
+	const __m256 min_y = _mm256_set1_ps(r.y);
+	const __m256 max_x = _mm256_set1_ps(r.x + r.length);
+	const __m256 max_y = _mm256_set1_ps(r.y + r.height);
+
+	int hits = 0;
+	int i = 0;
+	for (; i + 8 <= b.count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(b.x + i);
+		__m256 y = _mm256_loadu_ps(b.y + i);
+		__m256 x2 = _mm256_add_ps(x, _mm256_loadu_ps(b.length + i));
+		__m256 y2 = _mm256_add_ps(y, _mm256_loadu_ps(b.height + i));
+
+		__m256 overlap = _mm256_and_ps(
+			_mm256_and_ps(_mm256_cmp_ps(min_x, x2, _CMP_LE_OQ), _mm256_cmp_ps(x, max_x, _CMP_LE_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(min_y, y2, _CMP_LE_OQ), _mm256_cmp_ps(y, max_y, _CMP_LE_OQ)));
+
+		unsigned int lanes = static_cast<unsigned int>(_mm256_movemask_ps(overlap));
+		if (!lanes)
+		{
+			continue;
+		}
+
+		if (first_only)
+		{
+			return i + lowestLane(lanes);
+		}
+
+		hits += storeLanes(mask, i, lanes);
+	}
+
+	_mm256_zeroupper();
+	int tail = overlapScalar(r, b, i, mask, first_only);
+	return first_only ? tail : hits + tail;
+}
+
+/**
+*   @brief   Queries the CPU for SSE2 and usable AVX2 support.
+*   @details AVX2 also needs the OS to save the YMM registers, which
+			 is checked through XGETBV.
+*   @return  void
+*/
+static void detectCPU(bool& sse2, bool& avx2)
+{
+	unsigned int regs1[4] = { 0, 0, 0, 0 };
+	unsigned int regs7[4] = { 0, 0, 0, 0 };
+	unsigned int max_leaf = 0;
+
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	max_leaf = static_cast<unsigned int>(info[0]);
+	__cpuid(info, 1);
+	memcpy(regs1, info, sizeof(regs1));
+	if (max_leaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		memcpy(regs7, info, sizeof(regs7));
+	}
+#else
+	max_leaf = __get_cpuid_max(0, nullptr);
+	__get_cpuid(1, &regs1[0], &regs1[1], &regs1[2], &regs1[3]);
+	if (max_leaf >= 7)
+	{
+		__cpuid_count(7, 0, regs7[0], regs7[1], regs7[2], regs7[3]);
+	}
+#endif
+
+	sse2 = (regs1[3] & (1u << 26)) != 0;
+
+	bool osxsave = (regs1[2] & (1u << 27)) != 0;
+	bool avx = (regs1[2] & (1u << 28)) != 0;
+	avx2 = false;
+	if (osxsave && avx)
+	{
+		unsigned int xcr0_lo;
+#ifdef _MSC_VER
+		xcr0_lo = static_cast<unsigned int>(_xgetbv(0));
+#else
+		unsigned int xcr0_hi;
+		__asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+#endif
+		avx2 = (xcr0_lo & 0x6) == 0x6 && (regs7[1] & (1u << 5)) != 0;
+	}
+}
+
+#endif
+
+struct kernel_choice
+{
+	overlap_kernel kernel = kernelScalar;
+	const char* name = "scalar";
+
+	kernel_choice()
+	{
+#ifdef RECT_BATCH_X86
+		bool sse2 = false;
+		bool avx2 = false;
+		detectCPU(sse2, avx2);
+
+		if (avx2)
+		{
+			kernel = kernelAVX2;
+			name = "avx2";
+		}
+		else if (sse2)
+		{
+			kernel = kernelSSE2;
+			name = "sse2";
+		}
+#endif
+	}
+};
+
+static kernel_choice& chosenKernel()
+{
+	static kernel_choice choice;
+	return choice;
+}
+
+int overlapMask(const rect& r, const rect_batch& batch, uint64_t* mask)
+{
+	memset(mask, 0, ((batch.count + 63) / 64) * sizeof(uint64_t));
+	return chosenKernel().kernel(r, batch, mask, false);
+}
+
+int firstOverlap(const rect& r, const rect_batch& batch)
+{
+	return chosenKernel().kernel(r, batch, nullptr, true);
+}
+
+const char* overlapKernelName()
+{
+	return chosenKernel().name;
+}
+
+/**
+*   @brief   Switches the batch functions to another implementation.
+*   @details Not thread safe, nothing else may be using the batch
+			 functions while this runs.
+*   @return  False if the CPU or build doesn't support it.
+*/
+bool useOverlapKernel(const char* name)
+{
+	kernel_choice& choice = chosenKernel();
+	if (!strcmp(name, "scalar"))
+	{
+		choice.kernel = kernelScalar;
+		choice.name = "scalar";
+		return true;
+	}
+
+#ifdef RECT_BATCH_X86
+	bool sse2 = false;
+	bool avx2 = false;
+	detectCPU(sse2, avx2);
+
+	if (avx2 && !strcmp(name, "avx2"))
+	{
+		choice.kernel = kernelAVX2;
+		choice.name = "avx2";
+		return true;
+	}
+
+	if (sse2 && !strcmp(name, "sse2"))
+	{
+		choice.kernel = kernelSSE2;
+		choice.name = "sse2";
+		return true;
+	}
+#endif
+
+	return false;
+}
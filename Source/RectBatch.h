@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+#include "Rect.h"
+
+/**
+*  Rectangles packed as separate arrays of x, y, width and height.
+*  All four arrays must hold at least count values. No alignment is
+*  required.
+*/
+struct rect_batch
+{
+	const real* x = nullptr;
+	const real* y = nullptr;
+	const real* length = nullptr;
+	const real* height = nullptr;
+	int count = 0;
+};
+
+/**
+*  Tests one rectangle against many.
+*  Uses the same inclusive test as rect::isInside, four or eight
+*  rectangles at a time using SSE2 or AVX2 when the CPU supports them
+*  and a scalar loop otherwise. Fixed-point builds always use the
+*  scalar loop. The implementation is picked once, the first time a
+*  batch function is called.
+*  @param [in] r The rectangle to test.
+*  @param [in] batch The rectangles to test against.
+*  @param [out] mask One bit per rectangle, (count + 63) / 64 words.
+*  @return the number of rectangles that overlap.
+*/
+int overlapMask(const rect& r, const rect_batch& batch, uint64_t* mask);
+
+/**
+*  Finds the first of many rectangles that overlaps another.
+*  @param [in] r The rectangle to test.
+*  @param [in] batch The rectangles to test against.
+*  @return the index of the first overlap, or -1 if there are none.
+*/
+int firstOverlap(const rect& r, const rect_batch& batch);
+
+/**
+*  The name of the implementation in use, for logging.
+*  @return "avx2", "sse2" or "scalar".
+*/
+const char* overlapKernelName();
+
+/**
+*  Switches to an implementation by name, for tests and benchmarks.
+*  @param [in] name "avx2", "sse2" or "scalar".
+*  @return false if the CPU or build doesn't have it, in which case
+*  the implementation in use is kept.
+*/
+bool useOverlapKernel(const char* name);
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <vector>
+
+#include "Reports.h"
+#include "StressMode.h"
+#include "TrajectoryPredictor.h"
+
+void writeStressReport(FILE* report, int balls)
+{
+	StressConfig config;
+	if (balls > 0)
+	{
+		config.ball_count = balls;
+	}
+
+	fprintf(report, "balls %d, %d ticks per run\n", config.ball_count, 240);
+	fprintf(report, "threads  ms/tick  speedup  state hash\n");
+	for (const StressResult& result : measureStressScaling(config, 240))
+	{
+		fprintf(report, "%7d  %7.3f  %7.2f  %016llx\n", result.threads,
+			result.ms_per_tick, result.speedup, static_cast<unsigned long long>(result.state_hash));
+	}
+}
+
+void writeLaunchReport(FILE* report, int angles)
+{
+	SimConfig config;
+	std::vector<LaunchResult> results = measureLaunchAngles(config, angles, 600);
+
+	std::vector<float> clear_times;
+	fprintf(report, "  angle  cleared  seconds  lives lost  state hash\n");
+	for (const LaunchResult& result : results)
+	{
+		fprintf(report, "%7.2f  %7d  %7.2f  %10d  %016llx\n", toFloat(result.angle),
+			result.cleared ? 1 : 0, toFloat(result.clear_time), result.lives_lost,
+			static_cast<unsigned long long>(result.state_hash));
+		if (result.cleared)
+		{
+			clear_times.push_back(toFloat(result.clear_time));
+		}
+	}
+
+	fprintf(report, "\ncleared %d of %d\n", static_cast<int>(clear_times.size()), angles);
+	if (!clear_times.empty())
+	{
+		std::sort(clear_times.begin(), clear_times.end());
+		size_t last = clear_times.size() - 1;
+		fprintf(report, "clear time min %.2f, median %.2f, 90th %.2f, max %.2f\n",
+			clear_times[0], clear_times[last / 2], clear_times[last * 9 / 10], clear_times[last]);
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <stdio.h>
+
+/**
+*  Times the stress mode on increasing thread counts.
+*  @param [in] report Where the table is written.
+*  @param [in] balls Balls to move, 0 for the StressConfig default.
+*/
+void writeStressReport(FILE* report, int balls);
+
+/**
+*  Plays the level from many launch angles with a computer controlled
+*  paddle, writing each run and a summary of the clear times.
+*  @param [in] report Where the runs are written.
+*  @param [in] angles How many angles to try.
+*/
+void writeLaunchReport(FILE* report, int angles);
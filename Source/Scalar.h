@@ -0,0 +1,44 @@
+#pragma once
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+*  The number type used by the simulation.
+*  Defining BREAKOUT_FIXED_POINT for the whole build switches every
+*  position, size, speed and time in the simulation from float to
+*  fixed. Fixed-point builds produce bit-identical state from the
+*  same inputs on any compiler or CPU, so replays and validation
+*  runs can be compared with stateHash() rather than tolerances.
+*  @see fixed
+*/
+#ifdef BREAKOUT_FIXED_POINT
+
+#include "Fixed.h"
+typedef fixed  real;
+typedef fixed  time_real;  /**< Event times, fixed point keeps them exact. */
+
+inline float  toFloat(real value)    { return static_cast<float>(value); }
+inline real   absReal(real value)    { return abs(value); }
+inline real   sqrtReal(real value)   { return sqrt(value); }
+inline real   realMax()              { return fixed::max(); }
+inline uint64_t realBits(real value) { return static_cast<uint64_t>(value.rawValue()); }
+
+#else
+
+typedef float  real;
+typedef double time_real;  /**< Event times, double keeps long runs accurate. */
+
+inline float  toFloat(real value)    { return value; }
+inline real   absReal(real value)    { return fabsf(value); }
+inline real   sqrtReal(real value)   { return sqrtf(value); }
+inline real   realMax()              { return INFINITY; }
+
+inline uint64_t realBits(real value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include "Script.h"
+
+#ifdef BREAKOUT_COROUTINES
+
+#include <algorithm>
+
+void ScriptDelay::await_suspend(Script::Handle waiting) const
+{
+	waiting.promise().scheduler->wait(waiting, seconds);
+}
+
+ScriptScheduler::~ScriptScheduler()
+{
+	stopAll();
+}
+
+/**
+*   @brief   Starts a script.
+*   @details Scripts are created suspended, so the first resume runs
+			 them up to their first co_await. One that never waits
+			 is finished and destroyed straight away.
+*   @return  void
+*/
+void ScriptScheduler::start(Script script)
+{
+	Script::Handle handle = script.release();
+	handle.promise().scheduler = this;
+	running.push_back(handle);
+	resume(handle);
+}
+
+/**
+*   @brief   Resumes every script that is due.
+*   @details The wheel only moves in whole ticks, the fraction left
+			 over stays in the clock for the next update.
+*   @return  void
+*/
+void ScriptScheduler::update(double dt)
+{
+	clock += dt;
+	uint64_t tick = static_cast<uint64_t>(clock * tick_rate);
+	if (tick > timers.clock())
+	{
+		timers.advance(tick - timers.clock(),
+			[this](Script::Handle script) { resume(script); });
+	}
+}
+
+void ScriptScheduler::stopAll()
+{
+	for (Script::Handle script : running)
+	{
+		script.destroy();
+	}
+
+	running.clear();
+	timers = TimerWheel<Script::Handle>();
+}
+
+void ScriptScheduler::wait(Script::Handle script, double seconds)
+{
+	timers.schedule(static_cast<uint64_t>(seconds * tick_rate), script);
+}
+
+int ScriptScheduler::size() const
+{
+	return static_cast<int>(running.size());
+}
+
+/**
+*   @brief   Runs a script up to its next wait.
+*   @details Finished scripts stop at their final suspend point so
+			 they can be destroyed here, rather than freeing
+			 themselves while still on the stack.
+*   @return  void
+*/
+void ScriptScheduler::resume(Script::Handle script)
+{
+	script.resume();
+	if (script.done())
+	{
+		running.erase(std::find(running.begin(), running.end(), script));
+		script.destroy();
+	}
+}
+
+#endif
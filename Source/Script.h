@@ -0,0 +1,149 @@
+#pragma once
+#include <chrono>
+#include <exception>
+#include <vector>
+
+#include "TimerWheel.h"
+
+// C++20 coroutines, or the coroutines TS behind MSVC's /await
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define BREAKOUT_COROUTINES 1
+namespace coro = std;
+#elif defined(__cpp_coroutines) || defined(_RESUMABLE_FUNCTIONS_SUPPORTED)
+#include <experimental/coroutine>
+#define BREAKOUT_COROUTINES 1
+namespace coro = std::experimental;
+#endif
+
+#ifdef BREAKOUT_COROUTINES
+
+class ScriptScheduler;
+
+/**
+*  A gameplay script, written as a coroutine.
+*  A script is a function returning Script that waits with
+*  co_await after(...), so a sequence of timed events reads top to
+*  bottom instead of being spread over flags checked every frame.
+*  Nothing runs until the script is handed to a ScriptScheduler.
+*/
+class Script
+{
+public:
+	struct promise_type;
+	typedef coro::coroutine_handle<promise_type> Handle;
+
+	struct promise_type
+	{
+		ScriptScheduler* scheduler = nullptr;
+
+		Script get_return_object() { return Script(Handle::from_promise(*this)); }
+		coro::suspend_always initial_suspend() { return {}; }
+		coro::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+
+	Script(Script&& rhs) : handle(rhs.handle) { rhs.handle = nullptr; }
+	Script(const Script&) = delete;
+	Script& operator=(const Script&) = delete;
+	Script& operator=(Script&&) = delete;
+
+	~Script()
+	{
+		if (handle)
+		{
+			handle.destroy();
+		}
+	}
+
+	/**
+	*  Gives up ownership of the coroutine.
+	*/
+	Handle release()
+	{
+		Handle released = handle;
+		handle = nullptr;
+		return released;
+	}
+
+private:
+	explicit Script(Handle handle) : handle(handle) {}
+
+	Handle handle;
+};
+
+/**
+*  The awaitable returned by after().
+*/
+struct ScriptDelay
+{
+	double seconds;
+
+	bool await_ready() const { return seconds <= 0; }
+	void await_suspend(Script::Handle waiting) const;
+	void await_resume() const {}
+};
+
+/**
+*  Suspends a script for a while, co_await after(10s).
+*  Only scripts started on a ScriptScheduler can wait.
+*/
+template <typename Rep, typename Period>
+ScriptDelay after(std::chrono::duration<Rep, Period> delay)
+{
+	return ScriptDelay{ std::chrono::duration<double>(delay).count() };
+}
+
+/**
+*  Runs scripts against the game clock.
+*  Waiting scripts sit in a timer wheel of millisecond ticks, so a
+*  frame where none of them is due costs the same however many are
+*  waiting, and each one is only touched when it resumes.
+*/
+class ScriptScheduler
+{
+public:
+	ScriptScheduler() = default;
+	~ScriptScheduler();
+
+	ScriptScheduler(const ScriptScheduler&) = delete;
+	ScriptScheduler& operator=(const ScriptScheduler&) = delete;
+
+	/**
+	*  Takes ownership of a script and runs it up to its first wait.
+	*/
+	void start(Script script);
+
+	/**
+	*  Moves the clock on, resuming every script whose wait is over.
+	*  Resumed scripts may start other scripts.
+	*  @param [in] dt Seconds since the last update.
+	*/
+	void update(double dt);
+
+	/**
+	*  Destroys every script, waiting or not. Don't call this from
+	*  inside a script.
+	*/
+	void stopAll();
+
+	/**
+	*  Queues a suspended script to resume after a delay.
+	*  Called by after(), rather than directly.
+	*/
+	void wait(Script::Handle script, double seconds);
+
+	int size() const;
+
+private:
+	static const int tick_rate = 1000;  /**< Timer wheel ticks per second. */
+
+	void resume(Script::Handle script);
+
+	TimerWheel<Script::Handle> timers;
+	std::vector<Script::Handle> running;  /**< Every script started and not yet finished. */
+	double clock = 0;                     /**< Seconds since the scheduler was created. */
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include "Shapes.h"
+
+/**
+*   @brief   Finds when a moving point enters an interval.
+*   @return  False if the point can never be inside it.
+*/
+static bool enterInterval(real pos, real delta, real min, real max,
+	real& t_enter, real& t_exit)
+{
+	if (delta == 0)
+	{
+		if (pos < min || pos > max)
+		{
+			return false;
+		}
+
+		t_enter = -realMax();
+		t_exit = realMax();
+		return true;
+	}
+
+	real t1 = (min - pos) / delta;
+	real t2 = (max - pos) / delta;
+	t_enter = t1 < t2 ? t1 : t2;
+	t_exit = t1 < t2 ? t2 : t1;
+	return true;
+}
+
+/**
+*   @brief   Finds when a moving circle first touches a point.
+*   @details Solves |offset + d * s| = radius for the smaller root.
+			 The offset should be small, so the squares stay in range
+			 in fixed-point builds.
+*   @return  False if the circle misses or is moving away.
+*/
+static bool sweepToPoint(real ox, real oy, real dx, real dy,
+	real radius, real& s)
+{
+	real a = dx * dx + dy * dy;
+	real b = ox * dx + oy * dy;
+	real c = ox * ox + oy * oy - radius * radius;
+	if (a == 0 || b >= 0)
+	{
+		return false;
+	}
+
+	real discriminant = b * b - a * c;
+	if (discriminant <= 0)
+	{
+		return false;
+	}
+
+	s = (-b - sqrtReal(discriminant)) / a;
+	return true;
+}
+
+/**
+*   @brief   Turns the offset from a contact point into a unit normal.
+*   @details Dividing by the radius would be close, but any error
+			 would make every bounce off a corner speed the ball up.
+*   @return  void
+*/
+static void contactNormal(real ox, real oy, sweep_result& result)
+{
+	real length = sqrtReal(ox * ox + oy * oy);
+	result.normal_x = length > 0 ? ox / length : real(0);
+	result.normal_y = length > 0 ? oy / length : real(-1);
+}
+
+/**
+*   @brief   Sweeps a circle against a rectangle.
+*   @details The rectangle is grown by the radius and the centre is
+			 cast against it as a ray. If the ray enters in one of the
+			 grown rectangle's corners it is cast again against the
+			 circle around that corner, as the real shape is rounded
+			 there. A circle that starts overlapping reports time 0,
+			 but only if it is moving further in.
+*   @return  True if the target is struck during the move.
+*/
+bool sweepCircleRect(const circle& moving, real dx, real dy,
+	const rect& target, sweep_result& result)
+{
+	real left = target.x;
+	real right = target.x + target.length;
+	real top = target.y;
+	real bottom = target.y + target.height;
+	real r = moving.radius;
+
+	// already overlapping
+	if (Narrowphase<circle, rect>::overlap(moving, target))
+	{
+		real cx = moving.x < left ? left : (moving.x > right ? right : moving.x);
+		real cy = moving.y < top ? top : (moving.y > bottom ? bottom : moving.y);
+		real ox = moving.x - cx;
+		real oy = moving.y - cy;
+		real distance = sqrtReal(ox * ox + oy * oy);
+		if (distance == r)
+		{
+			// only touching, the same as grazing
+			return false;
+		}
+
+		real nx = 0;
+		real ny = 0;
+		if (distance > 0)
+		{
+			nx = ox / distance;
+			ny = oy / distance;
+		}
+		else
+		{
+			// the centre is inside, push out along the shallowest axis
+			real pen_x = moving.x - left < right - moving.x ? moving.x - left : right - moving.x;
+			real pen_y = moving.y - top < bottom - moving.y ? moving.y - top : bottom - moving.y;
+			if (pen_x < pen_y)
+			{
+				nx = moving.x - left < right - moving.x ? -1 : 1;
+			}
+			else
+			{
+				ny = moving.y - top < bottom - moving.y ? -1 : 1;
+			}
+		}
+
+		if (dx * nx + dy * ny >= 0)
+		{
+			return false;
+		}
+
+		result.time = 0;
+		result.normal_x = nx;
+		result.normal_y = ny;
+		return true;
+	}
+
+	real enter_x, exit_x, enter_y, exit_y;
+	if (!enterInterval(moving.x, dx, left - r, right + r, enter_x, exit_x) ||
+		!enterInterval(moving.y, dy, top - r, bottom + r, enter_y, exit_y))
+	{
+		return false;
+	}
+
+	real t_enter = enter_x > enter_y ? enter_x : enter_y;
+	real t_exit = exit_x < exit_y ? exit_x : exit_y;
+	if (t_enter > t_exit || t_exit <= 0 || t_enter > 1)
+	{
+		return false;
+	}
+
+	t_enter = t_enter < 0 ? 0 : t_enter;
+	real qx = moving.x + dx * t_enter;
+	real qy = moving.y + dy * t_enter;
+	bool outside_x = qx < left || qx > right;
+	bool outside_y = qy < top || qy > bottom;
+
+	if (outside_x && outside_y)
+	{
+		real corner_x = qx < left ? left : right;
+		real corner_y = qy < top ? top : bottom;
+		real ox = qx - corner_x;
+		real oy = qy - corner_y;
+
+		real s;
+		if (!sweepToPoint(ox, oy, dx, dy, r, s) || t_enter + s > 1)
+		{
+			return false;
+		}
+
+		result.time = t_enter + s;
+		contactNormal(ox + dx * s, oy + dy * s, result);
+		return true;
+	}
+
+	result.time = t_enter;
+	result.normal_x = 0;
+	result.normal_y = 0;
+	if (enter_x > enter_y)
+	{
+		result.normal_x = dx > 0 ? -1 : 1;
+	}
+	else
+	{
+		result.normal_y = dy > 0 ? -1 : 1;
+	}
+
+	return true;
+}
+
+/**
+*   @brief   Sweeps a circle against another circle.
+*   @details The same as sweeping a point against a circle with the
+			 two radii added together.
+*   @return  True if the target is struck during the move.
+*/
+bool sweepCircleCircle(const circle& moving, real dx, real dy,
+	const circle& target, sweep_result& result)
+{
+	real ox = moving.x - target.x;
+	real oy = moving.y - target.y;
+	real reach = moving.radius + target.radius;
+	real distance_sq = ox * ox + oy * oy;
+
+	if (distance_sq < reach * reach)
+	{
+		real distance = sqrtReal(distance_sq);
+		real nx = distance > 0 ? ox / distance : real(0);
+		real ny = distance > 0 ? oy / distance : real(-1);
+		if (dx * nx + dy * ny >= 0)
+		{
+			return false;
+		}
+
+		result.time = 0;
+		result.normal_x = nx;
+		result.normal_y = ny;
+		return true;
+	}
+
+	real s;
+	if (!sweepToPoint(ox, oy, dx, dy, reach, s) || s > 1)
+	{
+		return false;
+	}
+
+	result.time = s;
+	contactNormal(ox + dx * s, oy + dy * s, result);
+	return true;
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include "Rect.h"
+#include "Scalar.h"
+#include "Sweep.h"
+
+/**
+*  A circle given by its centre and radius.
+*/
+struct circle
+{
+	real x = 0;
+	real y = 0;
+	real radius = 0;
+};
+
+/**
+*  The circle that fits inside a rectangle.
+*  Used for round sprites such as the ball, whose bounding box is
+*  square.
+*/
+inline circle inscribedCircle(const rect& box)
+{
+	real half = (box.length < box.height ? box.length : box.height) / 2;
+
+	circle c;
+	c.x = box.x + box.length / 2;
+	c.y = box.y + box.height / 2;
+	c.radius = half;
+	return c;
+}
+
+/**
+*  Builds a shape from a sprite's bounding box.
+*  Lets code that stores plain boxes choose the shape an object is
+*  collided as with a typedef.
+*/
+template <typename Shape>
+Shape shapeFromBox(const rect& box);
+
+template <>
+inline rect shapeFromBox<rect>(const rect& box)
+{
+	return box;
+}
+
+template <>
+inline circle shapeFromBox<circle>(const rect& box)
+{
+	return inscribedCircle(box);
+}
+
+/**
+*  Narrowphase kernels for a pair of shapes.
+*  Only the pairs below are specialised, asking for any other pair
+*  fails to compile rather than falling back to a slower test. Every
+*  specialisation provides:
+*    overlap(a, b)  true if the shapes touch.
+*    sweep(a, dx, dy, b, result)  the time and normal of impact for
+*    a moved by (dx, dy) against a stationary b, with the same rules
+*    as the rectangle sweep in Sweep.h.
+*  The kernel is chosen from the argument types at compile time, so
+*  a loop over one pair of shapes has no virtual calls or shape
+*  switches in it.
+*/
+template <typename A, typename B>
+struct Narrowphase;
+
+template <>
+struct Narrowphase<rect, rect>
+{
+	static bool overlap(const rect& a, const rect& b)
+	{
+		return a.isInside(b);
+	}
+
+	static bool sweep(const rect& a, real dx, real dy,
+		const rect& b, sweep_result& result)
+	{
+		return ::sweep(a, dx, dy, b, result);
+	}
+};
+
+bool sweepCircleRect(const circle& moving, real dx, real dy,
+	const rect& target, sweep_result& result);
+
+bool sweepCircleCircle(const circle& moving, real dx, real dy,
+	const circle& target, sweep_result& result);
+
+template <>
+struct Narrowphase<circle, rect>
+{
+	static bool overlap(const circle& a, const rect& b)
+	{
+		real cx = a.x < b.x ? b.x : (a.x > b.x + b.length ? b.x + b.length : a.x);
+		real cy = a.y < b.y ? b.y : (a.y > b.y + b.height ? b.y + b.height : a.y);
+		real ox = a.x - cx;
+		real oy = a.y - cy;
+		return ox * ox + oy * oy <= a.radius * a.radius;
+	}
+
+	/**
+	*  Sweeps the circle against the rectangle grown by its radius,
+	*  which has rounded corners. Face hits report an axis normal,
+	*  corner hits report the normal of the corner's arc.
+	*/
+	static bool sweep(const circle& a, real dx, real dy,
+		const rect& b, sweep_result& result)
+	{
+		return sweepCircleRect(a, dx, dy, b, result);
+	}
+};
+
+template <>
+struct Narrowphase<circle, circle>
+{
+	static bool overlap(const circle& a, const circle& b)
+	{
+		real ox = a.x - b.x;
+		real oy = a.y - b.y;
+		real reach = a.radius + b.radius;
+		return ox * ox + oy * oy <= reach * reach;
+	}
+
+	static bool sweep(const circle& a, real dx, real dy,
+		const circle& b, sweep_result& result)
+	{
+		return sweepCircleCircle(a, dx, dy, b, result);
+	}
+};
+
+/**
+*  Tests two shapes for overlap with the kernel for their types.
+*/
+template <typename A, typename B>
+inline bool overlaps(const A& a, const B& b)
+{
+	return Narrowphase<A, B>::overlap(a, b);
+}
+
+/**
+*  Sweeps one shape against another with the kernel for their types.
+*  @see Narrowphase
+*/
+template <typename A, typename B>
+inline bool sweepShape(const A& moving, real dx, real dy,
+	const B& target, sweep_result& result)
+{
+	return Narrowphase<A, B>::sweep(moving, dx, dy, target, result);
+}
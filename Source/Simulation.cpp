@@ -0,0 +1,726 @@
+#include "Simulation.h"
+#include "BallSweep.h"
+
+/**
+*   @brief   Resets the simulation.
+*   @details Places the paddle and ball, lays out the blocks and
+			 hides all but the first gem above the screen.
+*   @return  void
+*/
+void Simulation::init(const SimConfig& cfg)
+{
+	config = cfg;
+	sim_state = SimState();
+	sim_state.rng = config.seed ? config.seed : 1;
+
+	sim_state.paddle.x = real(config.game_width) / 2;
+	sim_state.paddle.y = config.game_height - 100;
+	sim_state.paddle.length = config.paddle_width;
+	sim_state.paddle.height = config.paddle_height;
+
+	sim_state.balls.resize(1);
+	sim_state.balls[0].box.length = config.ball_width;
+	sim_state.balls[0].box.height = config.ball_height;
+	reset();
+	ball_sweep.clear();
+	swept_balls = 0;
+
+	rect field;
+	field.length = static_cast<real>(config.game_width);
+	field.height = static_cast<real>(config.game_height);
+	block_grid.resize(field, config.block_width, config.block_height);
+
+	sim_state.blocks.resize(config.block_columns * config.block_rows);
+	for (int i = 0; i < sim_state.blocks.size(); i++)
+	{
+		sim_state.blocks.setSize(i, config.block_width, config.block_height);
+	}
+	layoutBlocks();
+
+	for (int i = 0; i < SimState::max_gems; i++)
+	{
+		sim_state.gems[i].length = config.gem_width;
+		sim_state.gems[i].height = config.gem_height;
+		sim_state.gem_visible[i] = false;
+		respawnGem(i, -2000);
+	}
+	sim_state.gem_visible[0] = true;
+
+	timers = TimerWheel<SimTimer>();
+	gem_drop_timer = timers.schedule(timerTicks(config.gem_drop), SimTimer::GEM_DROP);
+
+	events_valid = false;
+	events_handled = 0;
+}
+
+/**
+*   @brief   Advances the simulation by a single step.
+*   @details The paddle moves first, then each ball is swept along
+			 its path so it can never pass through a block or the paddle
+			 however large the step is.
+*   @return  void
+*/
+void Simulation::step(real dt, const SimInput& input)
+{
+	if (isOver())
+	{
+		return;
+	}
+
+	events_valid = false;
+	sim_state.elapsed_time += dt;
+	runTimers(timerTicks(sim_state.elapsed_time));
+
+	paddleMovement(dt, input);
+	moveBalls(dt);
+	updateGems(dt);
+}
+
+const SimState& Simulation::state() const
+{
+	return sim_state;
+}
+
+const SimConfig& Simulation::getConfig() const
+{
+	return config;
+}
+
+/**
+*   @brief   Hashes the gameplay state.
+*   @details FNV-1a over the bits of every value in the state, in a
+			 fixed order so the result doesn't depend on padding.
+*   @return  The 64 bit hash.
+*/
+unsigned long long Simulation::stateHash() const
+{
+	unsigned long long hash = 14695981039346656037ull;
+	auto mix = [&hash](uint64_t value)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			hash ^= (value >> (i * 8)) & 0xff;
+			hash *= 1099511628211ull;
+		}
+	};
+	auto mixRect = [&mix](const rect& r)
+	{
+		mix(realBits(r.x));
+		mix(realBits(r.y));
+		mix(realBits(r.length));
+		mix(realBits(r.height));
+	};
+
+	mixRect(sim_state.paddle);
+	for (const SimBall& ball : sim_state.balls)
+	{
+		mixRect(ball.box);
+		mix(realBits(ball.direction.x));
+		mix(realBits(ball.direction.y));
+	}
+
+	const BrickField& blocks = sim_state.blocks;
+	for (int i = 0; i < blocks.size(); i++)
+	{
+		mixRect(blocks.bounds(i));
+		mix(blocks.isAlive(i));
+	}
+	mix(realBits(sim_state.block_offset));
+
+	for (int i = 0; i < SimState::max_gems; i++)
+	{
+		mixRect(sim_state.gems[i]);
+		mix(sim_state.gem_visible[i]);
+	}
+
+	mix(realBits(sim_state.elapsed_time));
+	mix(sim_state.gems_falling);
+	mix(static_cast<uint64_t>(sim_state.blocks_hit));
+	mix(static_cast<uint64_t>(sim_state.player_life));
+	mix(static_cast<uint64_t>(sim_state.score));
+	mix(sim_state.rng);
+	return hash;
+}
+
+bool Simulation::isWon() const
+{
+	return sim_state.blocks.aliveCount() == 0;
+}
+
+bool Simulation::isLost() const
+{
+	return sim_state.player_life <= 0;
+}
+
+bool Simulation::isOver() const
+{
+	return isWon() || isLost();
+}
+
+void Simulation::paddleMovement(real dt, const SimInput& input)
+{
+	rect& paddle = sim_state.paddle;
+
+	//Paddle Movement speed
+	if (input.paddle_left && paddle.x >= 0)
+	{
+		paddle.x -= config.paddle_velocity * dt;
+	}
+
+	if (input.paddle_right && paddle.x + paddle.length <= config.game_width)
+	{
+		paddle.x += config.paddle_velocity * dt;
+	}
+}
+
+/**
+*   @brief   Moves every ball.
+*   @details Each ball is swept against the world on its own, then
+			 the balls are bounced off each other. A ball that falls
+			 out of the bottom is removed, unless it is the last one.
+*   @return  void
+*/
+void Simulation::moveBalls(real dt)
+{
+	std::vector<SimBall>& balls = sim_state.balls;
+	for (SimBall& ball : balls)
+	{
+		moveBall(ball, dt);
+	}
+
+	collideBalls();
+
+	//Floor Reset
+	for (size_t i = balls.size(); i-- > 0;)
+	{
+		if (balls[i].box.y <= config.game_height + 50)
+		{
+			continue;
+		}
+
+		if (balls.size() > 1)
+		{
+			balls.erase(balls.begin() + i);
+		}
+		else
+		{
+			reset();
+			--sim_state.player_life;
+		}
+	}
+}
+
+/**
+*   @brief   Moves a ball, bouncing off anything in its path.
+*   @details Finds the earliest impact along the ball's displacement,
+			 moves up to it, reflects and carries on with the time that
+			 is left. Several bounces can happen in one step, up to
+			 max_impacts.
+*   @return  void
+*/
+void Simulation::moveBall(SimBall& ball, real dt)
+{
+	rect& box = ball.box;
+	vec2& dir = ball.direction;
+
+	//Ball Speed
+	real distance = (config.ball_velocity / 2) * dt;
+	real remaining = 1;
+
+	for (int i = 0; i < config.max_impacts && remaining > 0; i++)
+	{
+		real dx = distance * remaining * dir.x;
+		real dy = distance * remaining * dir.y;
+
+		sweep_result impact;
+		int block = -1;
+		if (!findImpact(box, dx, dy, 0, impact, block))
+		{
+			box.x += dx;
+			box.y += dy;
+			break;
+		}
+
+		box.x += dx * impact.time;
+		box.y += dy * impact.time;
+		remaining *= 1 - impact.time;
+
+		bounce(dir, impact.normal_x, impact.normal_y);
+
+		if (block >= 0)
+		{
+			hitBlock(block, dir);
+		}
+	}
+}
+
+/**
+*   @brief   Bounces balls that have run into each other.
+*   @details Candidate pairs come from the sort and sweep broadphase,
+			 which keeps its order from the last step. Touching balls
+			 that are closing swap the parts of their directions along
+			 the line between them and are pushed apart.
+*   @return  void
+*/
+void Simulation::collideBalls()
+{
+	std::vector<SimBall>& balls = sim_state.balls;
+	int count = static_cast<int>(balls.size());
+	for (int id = count; id < swept_balls; id++)
+	{
+		ball_sweep.remove(id);
+	}
+	swept_balls = count;
+
+	if (count < 2)
+	{
+		return;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		ball_sweep.update(i, balls[i].box);
+	}
+
+	ball_sweep.findPairs(ball_pairs);
+	for (const auto& pair : ball_pairs)
+	{
+		SimBall& a = balls[pair.first];
+		SimBall& b = balls[pair.second];
+		ball_shape shape_a = shapeFromBox<ball_shape>(a.box);
+		ball_shape shape_b = shapeFromBox<ball_shape>(b.box);
+		if (!::overlaps(shape_a, shape_b))
+		{
+			continue;
+		}
+
+		circle circle_a = inscribedCircle(a.box);
+		circle circle_b = inscribedCircle(b.box);
+		real ox = circle_a.x - circle_b.x;
+		real oy = circle_a.y - circle_b.y;
+		real distance = sqrtReal(ox * ox + oy * oy);
+		real nx = distance > 0 ? ox / distance : real(0);
+		real ny = distance > 0 ? oy / distance : real(-1);
+
+		vec2 normal(nx, ny);
+		real closing = dot(a.direction - b.direction, normal);
+		if (closing < 0)
+		{
+			a.direction = normalise(a.direction - normal * closing);
+			b.direction = normalise(b.direction + normal * closing);
+		}
+
+		real push = (circle_a.radius + circle_b.radius - distance) / 2;
+		a.box.x += nx * push;
+		a.box.y += ny * push;
+		b.box.x -= nx * push;
+		b.box.y -= ny * push;
+	}
+}
+
+/**
+*   @brief   Reflects the ball off a surface.
+*   @details Normals from a brick's corner are not axis aligned, so
+			 the direction is mirrored about the normal rather than
+			 just having one component flipped. A ball already moving
+			 away from the surface is left alone.
+*   @return  void
+*/
+void Simulation::bounce(vec2& dir, real normal_x, real normal_y)
+{
+	vec2 normal(normal_x, normal_y);
+	if (dot(dir, normal) < 0)
+	{
+		dir = reflect(dir, normal);
+	}
+}
+
+/**
+*   @brief   Finds the first thing the ball will hit.
+*   @details Walls and the ceiling are solved directly, the paddle
+			 and blocks are swept with the kernel for the ball's shape.
+			 The paddle is swept using the ball's motion relative to it,
+			 so a moving paddle is handled too.
+*   @param   paddle_dx How far the paddle moves over the same time.
+*   @param   block Set to the index of the block struck, or -1.
+*   @param   with_paddle False to let the ball pass through the paddle.
+*   @return  True if anything is struck during the move.
+*/
+bool Simulation::findImpact(const rect& ball, real dx, real dy, real paddle_dx,
+	sweep_result& impact, int& block, bool with_paddle) const
+{
+	block = -1;
+
+	//Wall and Ceiling Collision, the floor is open
+	bool found = sweepBallBounds(ball, dx, dy, real(config.game_width),
+		real(config.game_height), false, impact);
+
+	//Paddle Collision
+	ball_shape shape = shapeFromBox<ball_shape>(ball);
+	sweep_result hit;
+	if (with_paddle && sweepShape(shape, dx - paddle_dx, dy,
+		shapeFromBox<block_shape>(sim_state.paddle), hit) &&
+		(!found || hit.time < impact.time))
+	{
+		impact = hit;
+		found = true;
+	}
+
+	//Block Collision, only the blocks near the ball's path
+	rect path = ball;
+	path.x = dx < 0 ? ball.x + dx : ball.x;
+	path.y = dy < 0 ? ball.y + dy : ball.y;
+	path.length = ball.length + absReal(dx);
+	path.height = ball.height + absReal(dy);
+	findBlockCandidates(path);
+
+	return sweepBallBlocks<block_shape>(shape, dx, dy, sim_state.blocks, candidates,
+		found, impact, block);
+}
+
+/**
+*   @brief   Collects the live blocks that overlap an area.
+*   @details Uses the grid, or tests the area against the whole field
+			 with the batch overlap kernel when use_block_grid is off.
+			 That is often quicker for small levels.
+*   @return  void
+*/
+void Simulation::findBlockCandidates(const rect& path) const
+{
+	if (config.use_block_grid)
+	{
+		block_grid.query(path, candidates);
+		return;
+	}
+
+	const BrickField& blocks = sim_state.blocks;
+	candidates.clear();
+	overlaps.resize((blocks.size() + 63) / 64);
+	if (!overlapMask(path, blocks.batch(), overlaps.data()))
+	{
+		return;
+	}
+
+	const uint64_t* alive = blocks.aliveBits();
+	for (size_t word = 0; word < overlaps.size(); word++)
+	{
+		uint64_t bits = overlaps[word] & alive[word];
+		for (int bit = 0; bits; bit++, bits >>= 1)
+		{
+			if (bits & 1)
+			{
+				candidates.push_back(static_cast<int>(word * 64) + bit);
+			}
+		}
+	}
+}
+
+void Simulation::hitBlock(int i, vec2& direction)
+{
+	direction = normalise(direction);
+	sim_state.blocks.setAlive(i, false);
+	sim_state.blocks_hit++;
+	sim_state.score += 150;
+	block_grid.remove(i);
+
+	if (blockOffset() != sim_state.block_offset)
+	{
+		layoutBlocks();
+	}
+}
+
+void Simulation::updateGems(real dt)
+{
+	if (!sim_state.gems_falling)
+	{
+		return;
+	}
+
+	for (int i = 0; i < SimState::max_gems; i++)
+	{
+		if (!sim_state.gem_visible[i])
+		{
+			continue;
+		}
+
+		rect& gem = sim_state.gems[i];
+		gem.y += config.gem_velocity * dt;
+
+		if (gem.isInside(sim_state.paddle) && gemTouchesPaddle(i))
+		{
+			catchGem(i);
+		}
+		else if (gem.y >= config.game_height)
+		{
+			respawnGem(i, -200);
+		}
+	}
+}
+
+/**
+*   @brief   Converts seconds of play to timer wheel ticks.
+*   @details Rounds down, so a timer fires on the first step that
+			 reaches its time, never on the one before. Fixed-point
+			 builds stay in integers, so the tick doesn't depend on
+			 how the platform rounds floats.
+*   @return  The number of whole ticks.
+*/
+uint64_t Simulation::timerTicks(real seconds)
+{
+#ifdef BREAKOUT_FIXED_POINT
+	int64_t raw = seconds.rawValue();
+	return raw > 0 ? static_cast<uint64_t>(raw * timer_rate) >> fixed::fraction_bits : 0;
+#else
+	double ticks = static_cast<double>(toFloat(seconds)) * timer_rate;
+	return ticks > 0 ? static_cast<uint64_t>(ticks) : 0;
+#endif
+}
+
+/**
+*   @brief   Fires every timer due up to a tick.
+*   @details Costs nothing while no timer is due, however many are
+			 waiting.
+*   @return  void
+*/
+void Simulation::runTimers(uint64_t tick)
+{
+	if (tick > timers.clock())
+	{
+		timers.advance(tick - timers.clock(),
+			[this](SimTimer timer) { fireTimer(timer); });
+	}
+}
+
+void Simulation::fireTimer(SimTimer timer)
+{
+	switch (timer)
+	{
+	case SimTimer::GEM_DROP:
+		sim_state.gems_falling = true;
+		if (events_valid)
+		{
+			for (int i = 0; i < SimState::max_gems; i++)
+			{
+				scheduleGem(i);
+			}
+		}
+		break;
+
+	case SimTimer::NONE:
+		break;
+	}
+}
+
+void Simulation::catchGem(int i)
+{
+	sim_state.score += 10000;
+	respawnGem(i, -200);
+	spawnBalls(config.gem_balls);
+}
+
+void Simulation::spawnBalls(int count)
+{
+	std::vector<SimBall>& balls = sim_state.balls;
+	SimBall source = balls[0];
+
+	for (int i = 0; i < count && static_cast<int>(balls.size()) < config.max_balls; i++)
+	{
+		SimBall ball = source;
+		ball.direction = normalise(vec2(real(2 * (i + 1)) / (count + 1) - 1, -1));
+		balls.push_back(ball);
+	}
+}
+
+void Simulation::launchBall(vec2 direction)
+{
+	sim_state.balls[0].direction = direction;
+	events_valid = false;
+}
+
+/**
+*   @brief   Traces a ball down to the paddle line.
+*   @details The same loop as moveBall, but cast out one event horizon
+			 at a time and stopped where the bottom of the ball meets
+			 the top of the paddle.
+*   @return  True if the ball reaches the line within max_time.
+*/
+bool Simulation::traceBall(int index, real max_time, BallTrace& trace)
+{
+	SimBall& ball = sim_state.balls[index];
+	rect& box = ball.box;
+	vec2& dir = ball.direction;
+	real line = sim_state.paddle.y;
+	real speed = static_cast<real>(config.ball_velocity / 2);
+
+	trace.x = box.x;
+	trace.time = 0;
+	trace.direction = dir;
+	trace.bounces = 0;
+	trace.blocks_hit.clear();
+	if (box.y + box.height > line)
+	{
+		return false;
+	}
+
+	// enough for several passes of the whole field
+	const int max_bounces = 64 * (config.max_impacts + sim_state.blocks.size());
+	real elapsed = 0;
+	while (elapsed < max_time && trace.bounces < max_bounces)
+	{
+		real horizon = max_time - elapsed < config.event_horizon ?
+			max_time - elapsed : config.event_horizon;
+		real dx = speed * horizon * dir.x;
+		real dy = speed * horizon * dir.y;
+
+		sweep_result impact;
+		int block = -1;
+		bool found = findImpact(box, dx, dy, 0, impact, block, false);
+		if (!found)
+		{
+			impact.time = 1;
+		}
+
+		if (dy > 0 && box.y + box.height + dy * impact.time >= line)
+		{
+			real t = (line - box.y - box.height) / dy;
+			box.x += dx * t;
+			box.y += dy * t;
+			trace.x = box.x;
+			trace.time = elapsed + horizon * t;
+			trace.direction = dir;
+			return true;
+		}
+
+		box.x += dx * impact.time;
+		box.y += dy * impact.time;
+		elapsed += horizon * impact.time;
+		if (!found)
+		{
+			continue;
+		}
+
+		bounce(dir, impact.normal_x, impact.normal_y);
+		trace.bounces++;
+		if (block >= 0)
+		{
+			hitBlock(block, dir);
+			trace.blocks_hit.push_back(block);
+		}
+	}
+
+	return false;
+}
+
+/**
+*   @brief   Rounds a position down to a whole pixel.
+*/
+static int pixel(real value)
+{
+	int whole = static_cast<int>(value);
+	return value < whole ? whole - 1 : whole;
+}
+
+/**
+*   @brief   Checks a gem against the paddle pixel by pixel.
+*   @details Only called once the bounding boxes overlap. The masks are
+			 skipped if either is missing or doesn't match the size the
+			 sprite is drawn at.
+*   @return  True if a solid pixel of the gem touches the paddle.
+*/
+bool Simulation::gemTouchesPaddle(int i) const
+{
+	const CollisionMask* gem_mask = config.gem_mask.get();
+	const CollisionMask* paddle_mask = config.paddle_mask.get();
+	if (!gem_mask || !paddle_mask ||
+		gem_mask->width() != pixel(config.gem_width) ||
+		gem_mask->height() != pixel(config.gem_height) ||
+		paddle_mask->width() != pixel(config.paddle_width) ||
+		paddle_mask->height() != pixel(config.paddle_height))
+	{
+		return true;
+	}
+
+	const rect& gem = sim_state.gems[i];
+	const rect& paddle = sim_state.paddle;
+	return masksOverlap(*gem_mask, pixel(gem.x), pixel(gem.y),
+		*paddle_mask, pixel(paddle.x), pixel(paddle.y));
+}
+
+/**
+*   @brief   Positions the blocks in their grid.
+*   @details The live blocks are inserted into the broadphase again
+			 as every one of them has moved.
+*   @return  void
+*/
+void Simulation::layoutBlocks()
+{
+	sim_state.block_offset = blockOffset();
+	block_grid.clear();
+
+	BrickField& blocks = sim_state.blocks;
+	for (int i = 0; i < blocks.size(); i++)
+	{
+		int column = i % config.block_columns;
+		int row = i / config.block_columns;
+		blocks.setPosition(i, column * config.block_width,
+			row * config.block_height + sim_state.block_offset);
+
+		if (blocks.isAlive(i))
+		{
+			block_grid.insert(i, blocks.bounds(i));
+		}
+	}
+}
+
+/**
+*   @brief   How far the block grid should have dropped.
+*   @details The whole grid drops by 30 pixels for every 10 blocks
+			 destroyed, up to a maximum of 90 pixels.
+*   @return  The vertical offset of the grid.
+*/
+real Simulation::blockOffset() const
+{
+	if (sim_state.blocks_hit >= 30)
+	{
+		return 90;
+	}
+	else if (sim_state.blocks_hit >= 20)
+	{
+		return 60;
+	}
+	else if (sim_state.blocks_hit >= 10)
+	{
+		return 30;
+	}
+
+	return 0;
+}
+
+void Simulation::respawnGem(int i, real y)
+{
+	int range = config.game_width - static_cast<int>(config.gem_width);
+	sim_state.gems[i].x = static_cast<real>(range > 0 ? random() % range : 0);
+	sim_state.gems[i].y = y;
+}
+
+void Simulation::reset()
+{
+	sim_state.balls[0].box.x = real(config.game_width) / 2;
+	sim_state.balls[0].box.y = real(config.game_height) / 2;
+}
+
+/**
+*   @brief   Generates the next random number.
+*   @details A xorshift generator stored in the state, so two
+			 simulations given the same seed and inputs stay identical.
+*   @return  A non-negative random number.
+*/
+int Simulation::random()
+{
+	unsigned int x = sim_state.rng;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	sim_state.rng = x;
+	return static_cast<int>(x & 0x7fffffff);
+}
@@ -0,0 +1,314 @@
+#pragma once
+#include <memory>
+#include <queue>
+#include <vector>
+#include "BrickField.h"
+#include "CollisionMask.h"
+#include "Rect.h"
+#include "Shapes.h"
+#include "SortAndSweep.h"
+#include "Sweep.h"
+#include "TimerWheel.h"
+#include "UniformGrid.h"
+#include "Vector2.h"
+
+/**
+*  Player input sampled for a single simulation step.
+*  The simulation never reads the keyboard itself, the owning
+*  game translates its key events into one of these per step.
+*/
+struct SimInput
+{
+	bool paddle_left = false;
+	bool paddle_right = false;
+};
+
+/**
+*  Sizes and speeds used to build the playing field.
+*  Anything the simulation needs to know about the sprites
+*  (their dimensions) is copied in here, so it can be run
+*  without a renderer or a window.
+*/
+struct SimConfig
+{
+	int   game_width = 640;
+	int   game_height = 940;
+
+	real  paddle_width = 104;
+	real  paddle_height = 24;
+	real  ball_width = 22;
+	real  ball_height = 22;
+	real  block_width = 64;
+	real  block_height = 32;
+	int   block_columns = 10;
+	int   block_rows = 5;
+	real  gem_width = 48;
+	real  gem_height = 48;
+
+	int   paddle_velocity = 650;
+	int   ball_velocity = 650;
+	real  gem_velocity = 150;
+	real  gem_drop = 10;        /**< Seconds of play before the gems start falling. */
+	int   max_impacts = 8;      /**< Most bounces the ball can make in a single step. */
+	bool  use_block_grid = true;    /**< Cull blocks with the grid, or with the batch overlap kernel. */
+	real  event_horizon = 1;        /**< Furthest ahead advance() looks for the ball's next impact, in seconds. */
+
+	unsigned int seed = 1;      /**< Seed for the simulation's own random numbers. */
+
+	/**
+	*  Alpha masks for the paddle and gem textures. When both are set a
+	*  gem is only caught if a solid pixel of it touches a solid pixel
+	*  of the paddle, otherwise the bounding boxes decide. Masks are
+	*  shared, so copying the config is cheap.
+	*/
+	std::shared_ptr<const CollisionMask> paddle_mask;
+	std::shared_ptr<const CollisionMask> gem_mask;
+	real  mask_poll = real(1) / 120;  /**< How often advance() re-tests the masks while the boxes overlap. */
+
+	int   gem_balls = 0;        /**< Extra balls released when a gem is caught, 0 for single ball play. */
+	int   max_balls = 64;
+	real  multi_ball_step = real(1) / 120;  /**< Step advance() uses while more than one ball is in play. */
+};
+
+/**
+*  A ball in play.
+*/
+struct SimBall
+{
+	rect box;
+	vec2 direction{ 1, 1 };
+};
+
+/**
+*  Where a traced ball came down to the paddle line.
+*  @see Simulation::traceBall
+*/
+struct BallTrace
+{
+	real x = 0;                   /**< Left edge of the ball as it reaches the line. */
+	real time = 0;                /**< Seconds until it gets there. */
+	vec2 direction;               /**< Direction it is heading in when it arrives. */
+	int  bounces = 0;             /**< Walls, ceiling and blocks struck on the way. */
+	std::vector<int> blocks_hit;  /**< Blocks destroyed on the way, in order. */
+};
+
+/**
+*  The complete gameplay state.
+*  Plain data only, so it can be copied, compared and stored
+*  without touching any engine objects.
+*/
+struct SimState
+{
+	static const int max_blocks = 50;  /**< Blocks in the default level. */
+	static const int max_gems = 5;
+
+	rect paddle;
+	std::vector<SimBall> balls;  /**< Never empty, losing the last ball costs a life. */
+
+	BrickField blocks;
+	real  block_offset = 0;     /**< How far the block grid has dropped. */
+
+	rect gems[max_gems];
+	bool gem_visible[max_gems] = {};
+
+	real  elapsed_time = 0;     /**< Seconds of play so far. */
+	bool  gems_falling = false; /**< Set by the gem drop timer. */
+	int   blocks_hit = 0;
+	int   player_life = 3;
+	int   score = 0;
+	unsigned int rng = 1;
+};
+
+/**
+*  Headless Breakout simulation.
+*  Owns the gameplay state and advances it with step(), or with
+*  advance() which jumps straight from one event to the next while
+*  there is a single ball in play. It has
+*  no dependency on ASGE, so it can be driven by BreakoutGame
+*  or by a batch runner with no renderer at all.
+*  @see SimState
+*/
+class Simulation
+{
+public:
+	/**
+	*  Resets the state and lays out a new level.
+	*  @param [in] config The dimensions and speeds to use.
+	*/
+	void init(const SimConfig& config);
+
+	/**
+	*  Advances the simulation.
+	*  @param [in] dt The length of the step in seconds.
+	*  @param [in] input The player input for this step.
+	*/
+	void step(real dt, const SimInput& input);
+
+	/**
+	*  Advances the simulation from event to event.
+	*  Everything moves in straight lines between impacts, so the time
+	*  of the next wall, ceiling, paddle, block, floor and gem event is
+	*  solved directly and kept in a priority queue. Collision work is
+	*  only done when an event fires or the input changes, which makes
+	*  long runs cost per impact rather than per frame. The queue is
+	*  kept between calls until step() is used or the input changes.
+	*  While more than one ball is in play it falls back to fixed steps
+	*  of multi_ball_step, as every bounce would otherwise have to
+	*  reschedule the events of each ball it could meet.
+	*  @param [in] duration The time to advance by in seconds.
+	*  @param [in] input The player input, held for the whole duration.
+	*/
+	void advance(real duration, const SimInput& input);
+
+	/**
+	*  The number of events advance() has handled since init().
+	*/
+	unsigned long long eventCount() const;
+
+	/**
+	*  A hash of everything in the state.
+	*  Built from the exact bits of each value, so two runs only share
+	*  a hash if they are identical. Most useful in fixed-point builds,
+	*  where the same seed and inputs give the same hash everywhere.
+	*/
+	unsigned long long stateHash() const;
+
+	/**
+	*  Releases more balls from the first one.
+	*  The new balls fan out upwards. No more than max_balls are ever
+	*  in play at once.
+	*  @param [in] count How many balls to add.
+	*/
+	void spawnBalls(int count);
+
+	/**
+	*  Sends the first ball off in a new direction.
+	*  @param [in] direction The new direction, its length scales the
+	*  ball's speed.
+	*/
+	void launchBall(vec2 direction);
+
+	/**
+	*  Runs one ball forward until it comes down to the paddle line.
+	*  The ball bounces and destroys blocks by the same rules as in
+	*  step(), but the paddle, the gems and the other balls are
+	*  ignored and the clock doesn't move. Only the traced ball and
+	*  the blocks change, so this is meant to be run on a copy.
+	*  @param [in] ball The index of the ball to trace.
+	*  @param [in] max_time How far ahead to look in seconds.
+	*  @param [out] trace Where and when the ball arrives.
+	*  @return false if the ball doesn't reach the line in time, or is
+	*  already below it.
+	*  @see TrajectoryPredictor
+	*/
+	bool traceBall(int ball, real max_time, BallTrace& trace);
+
+	const SimState&  state() const;
+	const SimConfig& getConfig() const;
+
+	bool isWon() const;
+	bool isLost() const;
+	bool isOver() const;
+
+private:
+	typedef circle ball_shape;   /**< The ball sprite is round. */
+	typedef rect   block_shape;  /**< The paddle and the bricks are boxes. */
+
+	enum class EventType
+	{
+		BALL_IMPACT,   /**< The ball strikes a wall, the ceiling, the paddle or a block. */
+		BALL_FLOOR,    /**< The ball falls out of the bottom of the screen. */
+		BALL_REPLAN,   /**< Nothing within the horizon, look again from here. */
+		PADDLE_STOP,   /**< The paddle reaches a wall. */
+		TIMER_DUE,     /**< A timer on the wheel falls due, index is its tick. */
+		GEM_CATCH,     /**< A gem lands on the paddle. */
+		GEM_MISSED     /**< A gem falls off the screen. */
+	};
+
+	struct SimEvent
+	{
+		time_real time;
+		EventType type;
+		int       index;        /**< Block, gem or tick index, -1 when unused. */
+		unsigned  generation;   /**< Discarded if the actor has been rescheduled since. */
+		real      normal_x;
+		real      normal_y;
+	};
+
+	/**
+	*  Timed events, kept in a timer wheel running on elapsed_time.
+	*/
+	enum class SimTimer
+	{
+		NONE,
+		GEM_DROP       /**< The gems start falling. */
+	};
+
+	static const int timer_rate = 1000;  /**< Timer wheel ticks per second. */
+
+	struct LaterEvent
+	{
+		bool operator()(const SimEvent& a, const SimEvent& b) const { return a.time > b.time; }
+	};
+
+	void paddleMovement(real dt, const SimInput& input);
+	void moveBalls(real dt);
+	void moveBall(SimBall& ball, real dt);
+	void collideBalls();
+	void bounce(vec2& direction, real normal_x, real normal_y);
+	bool findImpact(const rect& ball, real dx, real dy, real paddle_dx,
+		sweep_result& impact, int& block, bool with_paddle = true) const;
+	void hitBlock(int i, vec2& direction);
+	void updateGems(real dt);
+	void catchGem(int i);
+	bool gemTouchesPaddle(int i) const;
+	void findBlockCandidates(const rect& path) const;
+	void layoutBlocks();
+	void respawnGem(int i, real y);
+	void reset();
+	int  random();
+
+	real blockOffset() const;
+
+	static uint64_t timerTicks(real seconds);
+	void runTimers(uint64_t tick);
+	void fireTimer(SimTimer timer);
+
+	void scheduleAll();
+	void scheduleBall();
+	void schedulePaddle();
+	void scheduleGem(int i);
+	void recheckGem(int i);
+	void advanceSteps(real duration, const SimInput& input);
+	void advanceTo(time_real time);
+	void handleEvent(const SimEvent& event);
+	bool isCurrent(const SimEvent& event) const;
+	void push(time_real time, EventType type, int index, unsigned generation,
+		real normal_x = 0, real normal_y = 0);
+
+	SimConfig config;
+	SimState  sim_state;
+
+	UniformGrid block_grid;                 /**< Broadphase holding the live blocks. */
+	mutable std::vector<int> candidates;    /**< Scratch list for broadphase queries. */
+	mutable std::vector<uint64_t> overlaps; /**< Scratch bitset for the batch overlap kernel. */
+
+	TimerWheel<SimTimer> timers;
+	TimerId gem_drop_timer;
+
+	SortAndSweep ball_sweep;                /**< Broadphase for ball against ball. */
+	std::vector<std::pair<int, int>> ball_pairs;
+	int swept_balls = 0;                    /**< How many ids ball_sweep holds. */
+
+	//Event driven mode
+	std::priority_queue<SimEvent, std::vector<SimEvent>, LaterEvent> events;
+	bool     events_valid = false;
+	SimInput event_input;
+	time_real event_clock = 0;              /**< Time of the last event, see time_real. */
+	real     paddle_speed = 0;              /**< Signed paddle velocity while advancing. */
+	unsigned ball_generation = 0;
+	unsigned paddle_generation = 0;
+	unsigned gem_generation[SimState::max_gems] = {};
+	int      zero_time_impacts = 0;
+	unsigned long long events_handled = 0;
+};
@@ -0,0 +1,394 @@
+#include "Simulation.h"
+
+/**
+*   @brief   Advances the simulation from event to event.
+*   @details Pops events in time order, moving everything up to each
+			 one before handling it. Events whose actor has been
+			 rescheduled since they were queued are skipped.
+*   @return  void
+*/
+void Simulation::advance(real duration, const SimInput& input)
+{
+	if (sim_state.balls.size() > 1)
+	{
+		advanceSteps(duration, input);
+		return;
+	}
+
+	if (!events_valid ||
+		input.paddle_left != event_input.paddle_left ||
+		input.paddle_right != event_input.paddle_right)
+	{
+		event_input = input;
+		scheduleAll();
+	}
+
+	time_real end = event_clock + duration;
+	while (!isOver() && !events.empty())
+	{
+		SimEvent event = events.top();
+		if (!isCurrent(event))
+		{
+			events.pop();
+			continue;
+		}
+
+		if (event.time > end)
+		{
+			break;
+		}
+
+		events.pop();
+		advanceTo(event.time);
+		handleEvent(event);
+		events_handled++;
+
+		if (sim_state.balls.size() > 1)
+		{
+			// a caught gem released more balls
+			advanceSteps(static_cast<real>(end - event_clock), input);
+			return;
+		}
+	}
+
+	if (!isOver())
+	{
+		advanceTo(end);
+	}
+}
+
+/**
+*   @brief   Advances in fixed steps, for multi-ball play.
+*   @return  void
+*/
+void Simulation::advanceSteps(real duration, const SimInput& input)
+{
+	while (duration > 0 && !isOver())
+	{
+		real dt = duration < config.multi_ball_step ? duration : config.multi_ball_step;
+		step(dt, input);
+		duration -= dt;
+	}
+}
+
+unsigned long long Simulation::eventCount() const
+{
+	return events_handled;
+}
+
+/**
+*   @brief   Rebuilds the event queue from the current state.
+*   @return  void
+*/
+void Simulation::scheduleAll()
+{
+	events = decltype(events)();
+	event_clock = sim_state.elapsed_time;
+	events_valid = true;
+	zero_time_impacts = 0;
+
+	schedulePaddle();
+	scheduleBall();
+
+	if (timers.isPending(gem_drop_timer))
+	{
+		int tick = static_cast<int>(timers.expiry(gem_drop_timer));
+		real due = real(tick) / timer_rate;
+		push(event_clock + (due - sim_state.elapsed_time), EventType::TIMER_DUE, tick, 0);
+	}
+
+	if (sim_state.gems_falling)
+	{
+		for (int i = 0; i < SimState::max_gems; i++)
+		{
+			scheduleGem(i);
+		}
+	}
+}
+
+/**
+*   @brief   Queues the ball's next event.
+*   @details Casts the ball's path out to the event horizon. If it
+			 reaches nothing in that time a replan is queued instead.
+*   @return  void
+*/
+void Simulation::scheduleBall()
+{
+	unsigned generation = ++ball_generation;
+
+	const rect& ball = sim_state.balls[0].box;
+	vec2 dir = sim_state.balls[0].direction;
+	real speed = static_cast<real>(config.ball_velocity / 2);
+	real vx = speed * dir.x;
+	real vy = speed * dir.y;
+	real horizon = config.event_horizon;
+
+	sweep_result impact;
+	int block = -1;
+	bool found = findImpact(ball, vx * horizon, vy * horizon,
+		paddle_speed * horizon, impact, block);
+	real impact_time = found ? impact.time * horizon : horizon;
+
+	//Floor Reset
+	if (vy > 0)
+	{
+		real floor_time = (config.game_height + 50 - ball.y) / vy;
+		floor_time = floor_time < 0 ? 0 : floor_time;
+		if (floor_time < impact_time)
+		{
+			push(event_clock + floor_time, EventType::BALL_FLOOR, -1, generation);
+			return;
+		}
+	}
+
+	if (!found)
+	{
+		push(event_clock + horizon, EventType::BALL_REPLAN, -1, generation);
+		return;
+	}
+
+	// a ball wedged between two surfaces can keep striking at the
+	// same instant, so let time move on before looking again
+	if (impact.time == 0 && ++zero_time_impacts > config.max_impacts)
+	{
+		zero_time_impacts = 0;
+		push(event_clock + 1e-4, EventType::BALL_REPLAN, -1, generation);
+		return;
+	}
+
+	if (impact.time > 0)
+	{
+		zero_time_impacts = 0;
+	}
+
+	push(event_clock + impact_time, EventType::BALL_IMPACT, block, generation,
+		impact.normal_x, impact.normal_y);
+}
+
+/**
+*   @brief   Works out the paddle's velocity and when it stops.
+*   @details The paddle moves at a constant speed until it reaches
+			 a wall, where it is stopped with a PADDLE_STOP event.
+*   @return  void
+*/
+void Simulation::schedulePaddle()
+{
+	unsigned generation = ++paddle_generation;
+	const rect& paddle = sim_state.paddle;
+
+	paddle_speed = 0;
+	if (event_input.paddle_left)
+	{
+		paddle_speed -= config.paddle_velocity;
+	}
+
+	if (event_input.paddle_right)
+	{
+		paddle_speed += config.paddle_velocity;
+	}
+
+	real gap = 0;
+	if (paddle_speed < 0)
+	{
+		gap = paddle.x;
+	}
+	else if (paddle_speed > 0)
+	{
+		gap = config.game_width - (paddle.x + paddle.length);
+	}
+
+	if (gap <= 0)
+	{
+		paddle_speed = 0;
+		return;
+	}
+
+	push(event_clock + gap / absReal(paddle_speed), EventType::PADDLE_STOP, -1, generation);
+}
+
+/**
+*   @brief   Queues a falling gem's next event.
+*   @details The gem is either caught by the paddle, which is swept
+			 relative to the gem, or falls off the bottom of the screen.
+*   @return  void
+*/
+void Simulation::scheduleGem(int i)
+{
+	unsigned generation = ++gem_generation[i];
+	if (!sim_state.gem_visible[i] || config.gem_velocity <= 0)
+	{
+		return;
+	}
+
+	const rect& gem = sim_state.gems[i];
+	real missed_time = (config.game_height - gem.y) / config.gem_velocity;
+	missed_time = missed_time < 0 ? 0 : missed_time;
+
+	sweep_result catch_hit;
+	if (sweep(gem, -paddle_speed * missed_time, config.gem_velocity * missed_time,
+		sim_state.paddle, catch_hit))
+	{
+		push(event_clock + catch_hit.time * missed_time, EventType::GEM_CATCH, i, generation);
+		return;
+	}
+
+	push(event_clock + missed_time, EventType::GEM_MISSED, i, generation);
+}
+
+/**
+*   @brief   Follows a gem that is level with the paddle.
+*   @details The boxes touched but the solid pixels didn't, so the
+			 masks are tested again every mask_poll seconds until they
+			 touch or the gem drops below the paddle. Polling rather
+			 than sweeping again means a catch that rounds to the
+			 current time can't be found over and over.
+*   @return  void
+*/
+void Simulation::recheckGem(int i)
+{
+	const rect& gem = sim_state.gems[i];
+	const rect& paddle = sim_state.paddle;
+	if (gem.y > paddle.y + paddle.height)
+	{
+		scheduleGem(i);
+		return;
+	}
+
+	unsigned generation = gem_generation[i];
+	real missed_time = (config.game_height - gem.y) / config.gem_velocity;
+	if (missed_time <= config.mask_poll)
+	{
+		push(event_clock + (missed_time < 0 ? 0 : missed_time),
+			EventType::GEM_MISSED, i, generation);
+		return;
+	}
+
+	push(event_clock + config.mask_poll, EventType::GEM_CATCH, i, generation);
+}
+
+/**
+*   @brief   Moves everything in a straight line up to a time.
+*   @return  void
+*/
+void Simulation::advanceTo(time_real time)
+{
+	real dt = static_cast<real>(time - event_clock);
+	if (dt <= 0)
+	{
+		return;
+	}
+
+	real speed = static_cast<real>(config.ball_velocity / 2);
+	SimBall& ball = sim_state.balls[0];
+	ball.box.x += speed * ball.direction.x * dt;
+	ball.box.y += speed * ball.direction.y * dt;
+	sim_state.paddle.x += paddle_speed * dt;
+
+	if (sim_state.gems_falling)
+	{
+		for (int i = 0; i < SimState::max_gems; i++)
+		{
+			if (sim_state.gem_visible[i])
+			{
+				sim_state.gems[i].y += config.gem_velocity * dt;
+			}
+		}
+	}
+
+	sim_state.elapsed_time += dt;
+	event_clock = time;
+}
+
+void Simulation::handleEvent(const SimEvent& event)
+{
+	switch (event.type)
+	{
+	case EventType::BALL_IMPACT:
+		bounce(sim_state.balls[0].direction, event.normal_x, event.normal_y);
+
+		if (event.index >= 0)
+		{
+			hitBlock(event.index, sim_state.balls[0].direction);
+		}
+
+		scheduleBall();
+		break;
+
+	case EventType::BALL_FLOOR:
+		reset();
+		--sim_state.player_life;
+		scheduleBall();
+		break;
+
+	case EventType::BALL_REPLAN:
+		scheduleBall();
+		break;
+
+	case EventType::PADDLE_STOP:
+		sim_state.paddle.x = paddle_speed < 0 ? 0 :
+			config.game_width - sim_state.paddle.length;
+		schedulePaddle();
+		scheduleBall();
+		for (int i = 0; i < SimState::max_gems; i++)
+		{
+			scheduleGem(i);
+		}
+		break;
+
+	case EventType::TIMER_DUE:
+		// elapsed_time can land a hair short of the tick, so run the
+		// wheel to the tick itself rather than converting back
+		runTimers(static_cast<uint64_t>(event.index));
+		break;
+
+	case EventType::GEM_CATCH:
+		if (!gemTouchesPaddle(event.index))
+		{
+			recheckGem(event.index);
+			break;
+		}
+
+		catchGem(event.index);
+		scheduleGem(event.index);
+		break;
+
+	case EventType::GEM_MISSED:
+		respawnGem(event.index, -200);
+		scheduleGem(event.index);
+		break;
+	}
+}
+
+bool Simulation::isCurrent(const SimEvent& event) const
+{
+	switch (event.type)
+	{
+	case EventType::BALL_IMPACT:
+	case EventType::BALL_FLOOR:
+	case EventType::BALL_REPLAN:
+		return event.generation == ball_generation;
+
+	case EventType::PADDLE_STOP:
+		return event.generation == paddle_generation;
+
+	case EventType::GEM_CATCH:
+	case EventType::GEM_MISSED:
+		return event.generation == gem_generation[event.index];
+
+	default:
+		return true;
+	}
+}
+
+void Simulation::push(time_real time, EventType type, int index, unsigned generation,
+	real normal_x, real normal_y)
+{
+	SimEvent event;
+	event.time = time;
+	event.type = type;
+	event.index = index;
+	event.generation = generation;
+	event.normal_x = normal_x;
+	event.normal_y = normal_y;
+	events.push(event);
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include "SortAndSweep.h"
+
+void SortAndSweep::clear()
+{
+	entries.clear();
+	slots.clear();
+	sorted = true;
+}
+
+void SortAndSweep::insert(int id, const rect& bounds)
+{
+	if (id >= static_cast<int>(slots.size()))
+	{
+		slots.resize(id + 1, -1);
+	}
+
+	Entry entry;
+	entry.id = id;
+	slots[id] = static_cast<int>(entries.size());
+	entries.push_back(entry);
+	update(id, bounds);
+}
+
+void SortAndSweep::remove(int id)
+{
+	if (id < 0 || id >= static_cast<int>(slots.size()) || slots[id] < 0)
+	{
+		return;
+	}
+
+	// erase rather than swap so the rest stay in order
+	entries.erase(entries.begin() + slots[id]);
+	slots[id] = -1;
+	for (int i = 0; i < static_cast<int>(entries.size()); i++)
+	{
+		slots[entries[i].id] = i;
+	}
+}
+
+void SortAndSweep::update(int id, const rect& bounds)
+{
+	if (id >= static_cast<int>(slots.size()) || slots[id] < 0)
+	{
+		insert(id, bounds);
+		return;
+	}
+
+	Entry& entry = entries[slots[id]];
+	entry.min_x = bounds.x;
+	entry.max_x = bounds.x + bounds.length;
+	entry.min_y = bounds.y;
+	entry.max_y = bounds.y + bounds.height;
+	sorted = false;
+}
+
+void SortAndSweep::query(const rect& area, std::vector<int>& results) const
+{
+	results.clear();
+	real max_x = area.x + area.length;
+	real max_y = area.y + area.height;
+
+	for (const Entry& entry : entries)
+	{
+		if (sorted && entry.min_x > max_x)
+		{
+			break;
+		}
+
+		if (entry.min_x <= max_x && entry.max_x >= area.x &&
+			entry.min_y <= max_y && entry.max_y >= area.y)
+		{
+			results.push_back(entry.id);
+		}
+	}
+}
+
+/**
+*   @brief   Finds every overlapping pair.
+*   @details After sorting, each entry only needs comparing with the
+			 entries that start before it ends on the x axis.
+*   @return  void
+*/
+void SortAndSweep::findPairs(std::vector<std::pair<int, int>>& pairs)
+{
+	pairs.clear();
+	sort();
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const Entry& a = entries[i];
+		for (size_t j = i + 1; j < entries.size() && entries[j].min_x <= a.max_x; j++)
+		{
+			const Entry& b = entries[j];
+			if (a.min_y <= b.max_y && b.min_y <= a.max_y)
+			{
+				pairs.push_back(a.id < b.id ?
+					std::make_pair(a.id, b.id) : std::make_pair(b.id, a.id));
+			}
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+}
+
+/**
+*   @brief   Restores the order along x.
+*   @details An insertion sort, as the entries are usually still in
+			 order or nearly so from the last time.
+*   @return  void
+*/
+void SortAndSweep::sort()
+{
+	if (sorted)
+	{
+		return;
+	}
+
+	for (size_t i = 1; i < entries.size(); i++)
+	{
+		Entry entry = entries[i];
+		size_t j = i;
+		while (j > 0 && entries[j - 1].min_x > entry.min_x)
+		{
+			entries[j] = entries[j - 1];
+			j--;
+		}
+		entries[j] = entry;
+	}
+
+	for (int i = 0; i < static_cast<int>(entries.size()); i++)
+	{
+		slots[entries[i].id] = i;
+	}
+
+	sorted = true;
+}
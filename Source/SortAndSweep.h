@@ -0,0 +1,53 @@
+#pragma once
+#include <utility>
+#include <vector>
+#include "Broadphase.h"
+
+/**
+*  A broadphase that keeps its objects sorted along the x axis.
+*  Suits a set of moving objects such as the balls. The order is
+*  kept between updates and repaired with an insertion sort, which
+*  is close to linear when objects have only moved a little since
+*  the last sort. Overlapping pairs are then found in one sweep.
+*  @see Broadphase
+*/
+class SortAndSweep : public Broadphase
+{
+public:
+	virtual void clear() override;
+	virtual void insert(int id, const rect& bounds) override;
+	virtual void remove(int id) override;
+	virtual void query(const rect& area, std::vector<int>& results) const override;
+
+	/**
+	*  Moves an object, inserting it if it isn't already present.
+	*  @param [in] id A non-negative id.
+	*  @param [in] bounds The area the object now covers.
+	*/
+	void update(int id, const rect& bounds);
+
+	/**
+	*  Collects every pair of objects whose bounds overlap.
+	*  Each pair is reported once with the lower id first, and the
+	*  list is sorted so it doesn't depend on the order objects were
+	*  inserted in.
+	*  @param [out] pairs Cleared and filled with overlapping pairs.
+	*/
+	void findPairs(std::vector<std::pair<int, int>>& pairs);
+
+private:
+	struct Entry
+	{
+		int  id;
+		real min_x;
+		real max_x;
+		real min_y;
+		real max_y;
+	};
+
+	void sort();
+
+	std::vector<Entry> entries;  /**< Sorted by min_x after sort(). */
+	std::vector<int>   slots;    /**< Where each id is in entries, -1 if absent. */
+	bool sorted = true;
+};
@@ -1,49 +1,79 @@
-#include <Engine\Renderer.h>
+#include <string.h>
+#include <Engine\Texture.h>
 #include "SpriteComponent.h"
 
-SpriteComponent::~SpriteComponent()
-{
-	freeSprite();
-}
-
 bool SpriteComponent::loadSprite(
-	ASGE::Renderer* renderer, const std::string& texture_file_name)
+	TextureCache& textures, const std::string& texture_file_name)
 {
-	freeSprite();
-	sprite = renderer->createRawSprite();
-	if (sprite->loadTexture(texture_file_name))
+	std::shared_ptr<ASGE::Sprite> loaded = textures.load(texture_file_name);
+	if (!loaded)
 	{
-		return true;
+		return false;
 	}
 
-	freeSprite();
-	return false;
+	sprite = loaded;
+	use_region = false;
+	return true;
 }
 
-void SpriteComponent::freeSprite()
+bool SpriteComponent::loadSprite(
+	TextureCache& textures, const TextureAtlas& atlas, const std::string& name)
 {
-	if (sprite)
+	const AtlasRegion* found = atlas.find(name);
+	if (!found)
 	{
-		delete sprite;
-		sprite = nullptr;
+		return false;
 	}
+
+	std::shared_ptr<ASGE::Sprite> loaded = textures.load(atlas.pagePath(found->page));
+	if (!loaded)
+	{
+		return false;
+	}
+
+	sprite = loaded;
+	use_region = true;
+	region[0] = static_cast<float>(found->x);
+	region[1] = static_cast<float>(found->y);
+	region[2] = static_cast<float>(found->width);
+	region[3] = static_cast<float>(found->height);
+	return true;
 }
 
 ASGE::Sprite* SpriteComponent::getSprite()
 {
-	return sprite;
+	return sprite.get();
 }
 
 
-rect SpriteComponent::getBoundingBox() const
+void SpriteComponent::applyTransform(const Transform& transform)
 {
-	rect bounding_box;
-	bounding_box.x = sprite->xPos();
-	bounding_box.y = sprite->yPos();
-	bounding_box.length = sprite->width();
-	bounding_box.height = sprite->height();
+	const rect& box = transform.bounds();
+	sprite->xPos(toFloat(box.x));
+	sprite->yPos(toFloat(box.y));
+	sprite->width(toFloat(box.length));
+	sprite->height(toFloat(box.height));
+	if (use_region)
+	{
+		memcpy(sprite->srcRect(), region, sizeof(region));
+	}
+}
+
+vec2 SpriteComponent::size() const
+{
+	if (use_region)
+	{
+		return vec2(region[2], region[3]);
+	}
 
-	return bounding_box;
+	// the shared sprite's own size is whatever was drawn last
+	const ASGE::Texture2D* texture = sprite ? sprite->getTexture() : nullptr;
+	if (!texture)
+	{
+		return vec2();
+	}
+	return vec2(static_cast<real>(static_cast<int>(texture->getWidth())),
+		static_cast<real>(static_cast<int>(texture->getHeight())));
 }
 
 //void SpriteComponent::isvi
\ No newline at end of file
@@ -1,13 +1,18 @@
 #pragma once
+#include <memory>
 #include <Engine\Sprite.h>
 #include "Rect.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "Transform.h"
 /**
-*  Sprite Components are used by GameObjects
-*  A component based approach allows GameObjects to decide
-*  on whether they want to have specific functionality. This
-*  is a better approach than using multiple inheritance to
-*  construct an object using classes as traits.
-*  @see GameObject
+*  Sprite Components are drawn for entities.
+*  Kept in a Pool by the game, one per texture, and referred to by
+*  the Renderable component of each entity drawn with it. The sprite
+*  comes from a TextureCache and may be shared with other components
+*  using the same texture, so it is moved to each entity's transform
+*  just before it is drawn.
+*  @see Renderable
 */
 class SpriteComponent
 {
@@ -19,20 +24,27 @@ public:
 	SpriteComponent() = default;
 
 	/**
-	*  Destructor. Frees dynamic memory.
+	*  Takes the sprite for a texture from the cache.
+	*  The file is only read if no other component is using it.
+	*  If this fails this function will return false and any sprite
+	*  held before is kept.
+	*  @param [in] textures The cache to share the texture through
+	*  @param [in] texture_file_name The file path to the the texture to load
+	*  @return true if the sprite was successfully loaded
 	*/
-	~SpriteComponent();
+	bool  loadSprite(TextureCache& textures, const std::string& texture_file_name);
 
 	/**
-	*  Allocates and loads the sprite.
-	*  Part of this process will attempt to load a texture file.
-	*  If this fails this function will return false and the memory
-	*  allocated, freed.
-	*  @param [in] renderer The renderer used to perform the allocations
-	*  @param [in] texture_file_name The file path to the the texture to load
-	*  @return true if the sprite was successfully loaded
+	*  Takes a sprite's region of an atlas page.
+	*  The page is shared through the cache with every other sprite
+	*  on it, and the region is drawn with the sprite's source rect.
+	*  @param [in] textures The cache to share the page through
+	*  @param [in] atlas The atlas holding the sprite
+	*  @param [in] name The sprite's name in the atlas
+	*  @return false if the atlas has no such sprite or its page
+	*  couldn't be loaded
 	*/
-	bool  loadSprite(ASGE::Renderer* renderer, const std::string& texture_file_name);
+	bool  loadSprite(TextureCache& textures, const TextureAtlas& atlas, const std::string& name);
 
 	/**
 	*  Returns a pointer to the sprite residing in this component.
@@ -43,17 +55,23 @@ public:
 	ASGE::Sprite* getSprite();
 
 	/**
-	*  Grabs a bounding box for the sprite.
-	*  Will create a bounding box as a rectangle. This can be used to check
-	*  for collisions with other rects.
-	*  @return a rectangle represent the sprite's position and bounds.
+	*  Moves and sizes the sprite to match a transform.
+	*  The sprite is never read back, the transform is the
+	*  authoritative copy.
+	*  @param [in] transform The position and size to draw at.
+	*/
+	void  applyTransform(const Transform& transform);
+
+	/**
+	*  The size of the image, its atlas region or its whole texture.
 	*/
-	rect  getBoundingBox() const;
+	vec2  size() const;
 
 
 
 
 private:
-	void freeSprite();
-	ASGE::Sprite* sprite = nullptr;
+	std::shared_ptr<ASGE::Sprite> sprite;
+	bool  use_region = false;
+	float region[4] = {};    /**< The source rect on an atlas page, x, y, width and height. */
 };
\ No newline at end of file
@@ -0,0 +1,283 @@
+#include <chrono>
+#include "BallSweep.h"
+#include "StressMode.h"
+#include "Vector2.h"
+
+void StressMode::init(const StressConfig& cfg)
+{
+	config = cfg;
+	pool.reset(new ThreadPool(config.threads));
+	hit_lists.assign(pool->size(), std::vector<int>());
+	candidates.assign(pool->size(), std::vector<int>());
+	destroyed = 0;
+
+	rect area;
+	area.length = config.game_width;
+	area.height = config.game_height;
+	grid.resize(area, config.block_width, config.block_height);
+
+	field.resize(config.block_columns * config.block_rows);
+	for (int i = 0; i < field.size(); i++)
+	{
+		field.setSize(i, config.block_width, config.block_height);
+	}
+	layoutBlocks();
+
+	// balls start anywhere below the bricks, heading anywhere
+	x.resize(config.ball_count);
+	y.resize(config.ball_count);
+	dir_x.resize(config.ball_count);
+	dir_y.resize(config.ball_count);
+
+	unsigned int rng = config.seed ? config.seed : 1;
+	auto random = [&rng](int range)
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		return static_cast<int>((rng & 0x7fffffff) % range);
+	};
+
+	int top = static_cast<int>(config.block_height * config.block_rows) + 100;
+	int width = config.game_width - static_cast<int>(config.ball_size);
+	int height = config.game_height - static_cast<int>(config.ball_size) - top;
+	std::vector<vec2> directions(config.ball_count);
+	for (int i = 0; i < config.ball_count; i++)
+	{
+		x[i] = real(random(width > 1 ? width : 1));
+		y[i] = real(top + random(height > 1 ? height : 1));
+
+		int dx = random(2001) - 1000;
+		int dy = -1 - random(1000);
+		directions[i] = vec2(real(dx), real(dy));
+	}
+
+	// one pass over every ball, two at a time where SSE2 is available
+	normaliseAll(directions.data(), config.ball_count);
+	for (int i = 0; i < config.ball_count; i++)
+	{
+		dir_x[i] = directions[i].x;
+		dir_y[i] = directions[i].y;
+	}
+}
+
+/**
+*   @brief   Advances every ball by one tick.
+*   @details The balls are moved in parallel against the bricks as
+			 they stood at the start of the tick. The hit lists are then
+			 merged on this thread, in chunk order, so the bricks
+			 removed never depend on how the threads were scheduled.
+*   @return  void
+*/
+void StressMode::tick(real dt)
+{
+	pool->parallelFor(config.ball_count, [this, dt](int begin, int end, int chunk)
+	{
+		moveBalls(begin, end, chunk, dt);
+	});
+
+	for (std::vector<int>& hits : hit_lists)
+	{
+		for (int block : hits)
+		{
+			if (field.isAlive(block))
+			{
+				field.setAlive(block, false);
+				grid.remove(block);
+				destroyed++;
+			}
+		}
+		hits.clear();
+	}
+
+	if (field.aliveCount() == 0)
+	{
+		layoutBlocks();
+	}
+}
+
+/**
+*   @brief   Moves a range of balls.
+*   @details Runs on a worker thread. Only the balls in the range and
+			 this chunk's lists are written, everything else is read.
+*   @return  void
+*/
+void StressMode::moveBalls(int begin, int end, int chunk, real dt)
+{
+	std::vector<int>& hits = hit_lists[chunk];
+	std::vector<int>& nearby = candidates[chunk];
+
+	real size = config.ball_size;
+	real distance = config.ball_velocity * dt;
+
+	for (int i = begin; i < end; i++)
+	{
+		real remaining = 1;
+		for (int impact = 0; impact < config.max_impacts && remaining > 0; impact++)
+		{
+			real dx = distance * remaining * dir_x[i];
+			real dy = distance * remaining * dir_y[i];
+
+			rect box;
+			box.x = x[i];
+			box.y = y[i];
+			box.length = size;
+			box.height = size;
+
+			// walls, ceiling and floor, then the bricks near the path
+			sweep_result first;
+			int struck = -1;
+			bool found = sweepBallBounds(box, dx, dy, real(config.game_width),
+				real(config.game_height), true, first);
+
+			rect path = box;
+			path.x = dx < 0 ? x[i] + dx : x[i];
+			path.y = dy < 0 ? y[i] + dy : y[i];
+			path.length = size + absReal(dx);
+			path.height = size + absReal(dy);
+			grid.queryConcurrent(path, nearby);
+			found = sweepBallBlocks<rect>(inscribedCircle(box), dx, dy, field, nearby,
+				found, first, struck);
+
+			x[i] += dx * first.time;
+			y[i] += dy * first.time;
+			remaining *= 1 - first.time;
+
+			if (!found)
+			{
+				break;
+			}
+
+			real along = dir_x[i] * first.normal_x + dir_y[i] * first.normal_y;
+			if (along < 0)
+			{
+				dir_x[i] -= 2 * along * first.normal_x;
+				dir_y[i] -= 2 * along * first.normal_y;
+			}
+
+			if (struck >= 0)
+			{
+				real length = sqrtReal(dir_x[i] * dir_x[i] + dir_y[i] * dir_y[i]);
+				dir_x[i] /= length;
+				dir_y[i] /= length;
+				hits.push_back(struck);
+			}
+		}
+	}
+}
+
+void StressMode::layoutBlocks()
+{
+	grid.clear();
+	for (int i = 0; i < field.size(); i++)
+	{
+		int column = i % config.block_columns;
+		int row = i / config.block_columns;
+		field.setPosition(i, column * config.block_width, row * config.block_height);
+		field.setAlive(i, true);
+		grid.insert(i, field.bounds(i));
+	}
+}
+
+int StressMode::ballCount() const
+{
+	return config.ball_count;
+}
+
+int StressMode::threadCount() const
+{
+	return pool ? pool->size() : 0;
+}
+
+unsigned long long StressMode::bricksDestroyed() const
+{
+	return destroyed;
+}
+
+const BrickField& StressMode::blocks() const
+{
+	return field;
+}
+
+const real* StressMode::ballX() const
+{
+	return x.data();
+}
+
+const real* StressMode::ballY() const
+{
+	return y.data();
+}
+
+unsigned long long StressMode::stateHash() const
+{
+	unsigned long long hash = 14695981039346656037ull;
+	auto mix = [&hash](uint64_t value)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			hash ^= (value >> (i * 8)) & 0xff;
+			hash *= 1099511628211ull;
+		}
+	};
+
+	for (int i = 0; i < config.ball_count; i++)
+	{
+		mix(realBits(x[i]));
+		mix(realBits(y[i]));
+		mix(realBits(dir_x[i]));
+		mix(realBits(dir_y[i]));
+	}
+
+	for (int i = 0; i < field.size(); i++)
+	{
+		mix(field.isAlive(i));
+	}
+
+	mix(destroyed);
+	return hash;
+}
+
+std::vector<StressResult> measureStressScaling(const StressConfig& config,
+	int ticks, int max_threads)
+{
+	if (max_threads <= 0)
+	{
+		max_threads = static_cast<int>(std::thread::hardware_concurrency());
+		max_threads = max_threads > 0 ? max_threads : 1;
+	}
+
+	std::vector<StressResult> results;
+	for (int threads = 1; ; threads *= 2)
+	{
+		threads = threads < max_threads ? threads : max_threads;
+
+		StressConfig run = config;
+		run.threads = threads;
+		StressMode stress;
+		stress.init(run);
+
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ticks; i++)
+		{
+			stress.tick(real(1) / 120);
+		}
+		std::chrono::duration<double, std::milli> taken =
+			std::chrono::steady_clock::now() - start;
+
+		StressResult result;
+		result.threads = threads;
+		result.ms_per_tick = taken.count() / (ticks > 0 ? ticks : 1);
+		result.speedup = results.empty() || result.ms_per_tick <= 0 ? 1 :
+			results.front().ms_per_tick / result.ms_per_tick;
+		result.state_hash = stress.stateHash();
+		results.push_back(result);
+
+		if (threads == max_threads)
+		{
+			break;
+		}
+	}
+
+	return results;
+}
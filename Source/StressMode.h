@@ -0,0 +1,106 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "BrickField.h"
+#include "Scalar.h"
+#include "ThreadPool.h"
+#include "UniformGrid.h"
+
+/**
+*  Settings for a stress run.
+*/
+struct StressConfig
+{
+	int  ball_count = 100000;
+	int  threads = 0;           /**< Threads to move balls on, 0 for one per hardware thread. */
+
+	int  game_width = 640;
+	int  game_height = 940;
+	real ball_size = 22;
+	real ball_velocity = 325;
+	real block_width = 64;
+	real block_height = 32;
+	int  block_columns = 10;
+	int  block_rows = 5;
+	int  max_impacts = 8;
+
+	unsigned int seed = 1;
+};
+
+/**
+*  Many thousands of balls bouncing around the brick field at once.
+*  Used to find how far the collision code scales, not to play. The
+*  balls are stored as separate arrays and split into one chunk per
+*  thread each tick. During the tick bricks are only read, every
+*  thread records the bricks its balls struck in its own hit list,
+*  and the lists are merged in chunk order afterwards. As the chunks
+*  are in ball order the result is the same for any thread count.
+*  Balls bounce off all four walls, and the field is rebuilt once
+*  every brick is gone.
+*/
+class StressMode
+{
+public:
+	void init(const StressConfig& config);
+
+	/**
+	*  Moves every ball and removes the bricks they struck.
+	*  @param [in] dt The length of the tick in seconds.
+	*/
+	void tick(real dt);
+
+	int ballCount() const;
+	int threadCount() const;
+	unsigned long long bricksDestroyed() const;
+
+	const BrickField& blocks() const;
+	const real* ballX() const;
+	const real* ballY() const;
+
+	/**
+	*  A hash of every ball and brick, to check runs on different
+	*  thread counts agree.
+	*/
+	unsigned long long stateHash() const;
+
+private:
+	void moveBalls(int begin, int end, int chunk, real dt);
+	void layoutBlocks();
+
+	StressConfig config;
+	std::unique_ptr<ThreadPool> pool;
+
+	std::vector<real> x;
+	std::vector<real> y;
+	std::vector<real> dir_x;
+	std::vector<real> dir_y;
+
+	BrickField  field;
+	UniformGrid grid;
+
+	std::vector<std::vector<int>> hit_lists;   /**< Bricks struck this tick, one list per chunk. */
+	std::vector<std::vector<int>> candidates;  /**< Broadphase scratch, one per chunk. */
+	unsigned long long destroyed = 0;
+};
+
+/**
+*  The time taken per tick for one thread count.
+*/
+struct StressResult
+{
+	int    threads = 0;
+	double ms_per_tick = 0;
+	double speedup = 1;                /**< Relative to one thread. */
+	unsigned long long state_hash = 0; /**< Should match for every thread count. */
+};
+
+/**
+*  Times the same stress run on 1, 2, 4 ... threads.
+*  @param [in] config The run to time, its thread count is ignored.
+*  @param [in] ticks How many ticks of 1/120 s to time.
+*  @param [in] max_threads The most threads to try, 0 for the
+*  number of hardware threads.
+*  @return one result per thread count tried.
+*/
+std::vector<StressResult> measureStressScaling(const StressConfig& config,
+	int ticks, int max_threads = 0);
@@ -0,0 +1,98 @@
+#include "Sweep.h"
+
+/**
+*   @brief   Computes the entry and exit times along one axis.
+*   @details When there is no movement on the axis the times are
+			 either unbounded or the slab is missed entirely.
+*   @return  False if the axis can never overlap.
+*/
+static bool slab(real pos, real delta, real min, real max,
+	real& t_enter, real& t_exit)
+{
+	if (delta == 0)
+	{
+		if (pos <= min || pos >= max)
+		{
+			return false;
+		}
+
+		t_enter = -realMax();
+		t_exit = realMax();
+		return true;
+	}
+
+	real t1 = (min - pos) / delta;
+	real t2 = (max - pos) / delta;
+	t_enter = t1 < t2 ? t1 : t2;
+	t_exit = t1 < t2 ? t2 : t1;
+	return true;
+}
+
+bool sweep(const rect& moving, real dx, real dy,
+	const rect& target, sweep_result& result)
+{
+	real min_x = target.x - moving.length;
+	real max_x = target.x + target.length;
+	real min_y = target.y - moving.height;
+	real max_y = target.y + target.height;
+
+	real enter_x, exit_x, enter_y, exit_y;
+	if (!slab(moving.x, dx, min_x, max_x, enter_x, exit_x) ||
+		!slab(moving.y, dy, min_y, max_y, enter_y, exit_y))
+	{
+		return false;
+	}
+
+	real t_enter = enter_x > enter_y ? enter_x : enter_y;
+	real t_exit = exit_x < exit_y ? exit_x : exit_y;
+	if (t_enter > t_exit || t_exit <= 0 || t_enter > 1)
+	{
+		return false;
+	}
+
+	real nx = 0;
+	real ny = 0;
+	if (t_enter >= 0)
+	{
+		if (enter_x > enter_y)
+		{
+			nx = dx > 0 ? -1 : 1;
+		}
+		else
+		{
+			ny = dy > 0 ? -1 : 1;
+		}
+	}
+	else
+	{
+		// already overlapping, push out along the shallowest axis
+		real left = moving.x - min_x;
+		real right = max_x - moving.x;
+		real top = moving.y - min_y;
+		real bottom = max_y - moving.y;
+		real pen_x = left < right ? left : right;
+		real pen_y = top < bottom ? top : bottom;
+
+		if (pen_x < pen_y)
+		{
+			nx = left < right ? -1 : 1;
+		}
+		else
+		{
+			ny = top < bottom ? -1 : 1;
+		}
+
+		t_enter = 0;
+	}
+
+	// only count it when moving into the surface
+	if (nx * dx + ny * dy >= 0)
+	{
+		return false;
+	}
+
+	result.time = t_enter;
+	result.normal_x = nx;
+	result.normal_y = ny;
+	return true;
+}
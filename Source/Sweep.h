@@ -0,0 +1,33 @@
+#pragma once
+#include "Rect.h"
+#include "Scalar.h"
+
+/**
+*  The result of sweeping one rectangle against another.
+*  Time is expressed as a fraction of the displacement, so 0 is
+*  the start of the move and 1 the end. The normal points away
+*  from the surface that was struck.
+*/
+struct sweep_result
+{
+	real time = 1;
+	real normal_x = 0;
+	real normal_y = 0;
+};
+
+/**
+*  Finds the time of impact of a moving rectangle.
+*  The target is expanded by the size of the moving rectangle and a
+*  ray is cast from the moving rectangle's corner along the
+*  displacement. A move that starts overlapping the target reports an
+*  impact at time 0 along the axis of least penetration. Moves that
+*  only graze the target or travel away from it are not impacts.
+*  @param [in] moving The rectangle at the start of the move.
+*  @param [in] dx The displacement on the x axis.
+*  @param [in] dy The displacement on the y axis.
+*  @param [in] target The stationary rectangle to test against.
+*  @param [out] result The time and normal of the impact.
+*  @return true if the target is struck during the move.
+*/
+bool sweep(const rect& moving, real dx, real dy,
+	const rect& target, sweep_result& result);
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "TextureAtlas.h"
+
+/**
+*   @brief   Reads an atlas file.
+*   @details One entry per line, blank lines and lines starting with
+			 '#' are skipped. Regions must refer to a page declared
+			 above them.
+*   @return  False if the file can't be read or a line is malformed.
+*/
+bool TextureAtlas::load(const std::string& path)
+{
+	clear();
+
+	FILE* file = fopen(path.c_str(), "r");
+	if (!file)
+	{
+		return false;
+	}
+
+	size_t separator = path.find_last_of("/\\");
+	directory = separator == std::string::npos ? "" : path.substr(0, separator + 1);
+
+	bool ok = true;
+	char line[512];
+	while (ok && fgets(line, sizeof(line), file))
+	{
+		char name[256];
+		AtlasRegion region;
+		if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+		{
+			continue;
+		}
+
+		if (sscanf(line, "page %255s", name) == 1)
+		{
+			addPage(name);
+		}
+		else if (sscanf(line, "region %255s %d %d %d %d %d", name, &region.x, &region.y,
+			&region.width, &region.height, &region.page) == 6 &&
+			region.page >= 0 && region.page < pageCount())
+		{
+			addRegion(name, region);
+		}
+		else
+		{
+			ok = false;
+		}
+	}
+
+	fclose(file);
+	if (!ok)
+	{
+		clear();
+	}
+	return ok;
+}
+
+bool TextureAtlas::save(const std::string& path) const
+{
+	FILE* file = fopen(path.c_str(), "w");
+	if (!file)
+	{
+		return false;
+	}
+
+	fprintf(file, "# sprite atlas, regions are name x y width height page\n");
+	for (const std::string& page : pages)
+	{
+		fprintf(file, "page %s\n", page.c_str());
+	}
+
+	for (const std::string& name : names)
+	{
+		const AtlasRegion& region = regions.at(name);
+		fprintf(file, "region %s %d %d %d %d %d\n", name.c_str(), region.x, region.y,
+			region.width, region.height, region.page);
+	}
+
+	return fclose(file) == 0;
+}
+
+void TextureAtlas::clear()
+{
+	directory.clear();
+	pages.clear();
+	regions.clear();
+	names.clear();
+}
+
+int TextureAtlas::addPage(const std::string& file_name)
+{
+	pages.push_back(file_name);
+	return pageCount() - 1;
+}
+
+void TextureAtlas::addRegion(const std::string& name, const AtlasRegion& region)
+{
+	if (regions.find(name) == regions.end())
+	{
+		names.push_back(name);
+	}
+	regions[name] = region;
+}
+
+const AtlasRegion* TextureAtlas::find(const std::string& name) const
+{
+	auto it = regions.find(name);
+	return it == regions.end() ? nullptr : &it->second;
+}
+
+std::string TextureAtlas::pagePath(int page) const
+{
+	return directory + pages[page];
+}
+
+int TextureAtlas::pageCount() const
+{
+	return static_cast<int>(pages.size());
+}
+
+int TextureAtlas::regionCount() const
+{
+	return static_cast<int>(names.size());
+}
+
+std::string TextureAtlas::spriteName(const std::string& texture_file_name)
+{
+	size_t start = texture_file_name.find_last_of("/\\");
+	std::string name = texture_file_name.substr(start == std::string::npos ? 0 : start + 1);
+	return name.substr(0, name.find_last_of('.'));
+}
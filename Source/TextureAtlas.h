@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+*  Where one sprite sits in an atlas, in pixels.
+*/
+struct AtlasRegion
+{
+	int page = 0;
+	int x = 0;
+	int y = 0;
+	int width = 0;
+	int height = 0;
+};
+
+/**
+*  A lookup from sprite name to a region of an atlas page.
+*  Saved as a small text file next to its page images:
+*
+*      page breakout_0.png
+*      region paddleBlue 0 0 104 24 0
+*
+*  Page files are relative to the atlas file. Regions give the page
+*  index last. Sprites draw their region with Sprite::srcRect, so
+*  every sprite on one page shares a single texture.
+*  @see AtlasBuilder
+*/
+class TextureAtlas
+{
+public:
+	/**
+	*  Reads an atlas file, replacing anything held.
+	*  @return false if the file is missing or malformed.
+	*/
+	bool load(const std::string& path);
+
+	bool save(const std::string& path) const;
+
+	void clear();
+
+	/**
+	*  @param [in] file_name The page image, relative to the atlas file.
+	*  @return the new page's index.
+	*/
+	int  addPage(const std::string& file_name);
+	void addRegion(const std::string& name, const AtlasRegion& region);
+
+	/**
+	*  @return the region, or nullptr if there is no sprite of that name.
+	*/
+	const AtlasRegion* find(const std::string& name) const;
+
+	/**
+	*  The path of a page image, including the atlas file's directory.
+	*/
+	std::string pagePath(int page) const;
+
+	int pageCount() const;
+	int regionCount() const;
+
+	/**
+	*  The name a texture file's sprite has in an atlas, its file name
+	*  without the directory or extension.
+	*/
+	static std::string spriteName(const std::string& texture_file_name);
+
+private:
+	std::string directory;                 /**< Where the atlas was loaded from, ending in a separator. */
+	std::vector<std::string> pages;
+	std::unordered_map<std::string, AtlasRegion> regions;
+	std::vector<std::string> names;        /**< Region names in the order added, so saves are stable. */
+};
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <Engine/Renderer.h>
+#include <Engine/Sprite.h>
+#include <Engine/Texture.h>
+
+#include "AssetLoader.h"
+#include "FilePath.h"
+#include "PngCodec.h"
+#include "TextureCache.h"
+
+namespace
+{
+	bool writeBlank(const std::string& path, const ImageView& image)
+	{
+		Image blank;
+		blank.resize(image.width, image.height);
+		return savePng(path, blank);
+	}
+
+	/**
+	*  setData takes the texture's own size and format, so both must
+	*  match the pixels.
+	*/
+	bool fitsTexture(const ASGE::Sprite& sprite, const ImageView& image)
+	{
+		const ASGE::Texture2D* texture = sprite.getTexture();
+		return texture && texture->getFormat() == ASGE::Texture2D::RGBA &&
+			texture->getWidth() == static_cast<unsigned int>(image.width) &&
+			texture->getHeight() == static_cast<unsigned int>(image.height);
+	}
+}
+
+TextureCache::TextureCache(ASGE::Renderer* renderer) : renderer(renderer)
+{
+}
+
+void TextureCache::setRenderer(ASGE::Renderer* new_renderer)
+{
+	renderer = new_renderer;
+}
+
+void TextureCache::setImages(const AssetLoader* loader)
+{
+	images = loader;
+}
+
+/**
+*   @brief   Finds or loads a texture.
+*   @details A live entry is handed straight back. Otherwise a sprite
+			 is created and given the texture, from memory when the
+			 loader has its pixels and from the file when not, and the
+			 entry is replaced. Failed loads aren't cached, so a missing
+			 file is tried again on the next request.
+*   @return  The shared sprite, or nullptr on failure.
+*/
+std::shared_ptr<ASGE::Sprite> TextureCache::load(const std::string& texture_file_name)
+{
+	std::string key = normalisePath(texture_file_name);
+	std::weak_ptr<ASGE::Sprite>& entry = entries[key];
+	if (std::shared_ptr<ASGE::Sprite> sprite = entry.lock())
+	{
+		hits++;
+		return sprite;
+	}
+
+	if (!renderer)
+	{
+		entries.erase(key);
+		return nullptr;
+	}
+
+	std::shared_ptr<ASGE::Sprite> sprite(renderer->createRawSprite());
+	loads++;
+	if (!sprite || !(loadFromMemory(*sprite, texture_file_name) ||
+		sprite->loadTexture(texture_file_name)))
+	{
+		entries.erase(key);
+		return nullptr;
+	}
+
+	entry = sprite;
+	return sprite;
+}
+
+/**
+*   @brief   Makes a texture from pixels the loader already holds.
+*   @details ASGE can't make a texture from memory, so a blank PNG of
+			 the same size is loaded and the pixels are uploaded over
+			 it. The blank is written the first time it's needed, and
+			 again if the image has changed size since.
+*   @return  False if the texture has to be loaded from its file.
+*/
+bool TextureCache::loadFromMemory(ASGE::Sprite& sprite, const std::string& texture_file_name)
+{
+	const ImageView* image = images ? images->image(texture_file_name) : nullptr;
+	if (!image)
+	{
+		return false;
+	}
+
+	std::string placeholder = placeholderPath(texture_file_name);
+	FILE* existing = fopen(placeholder.c_str(), "rb");
+	bool fresh = !existing;
+	if (existing)
+	{
+		fclose(existing);
+	}
+
+	if ((fresh && !writeBlank(placeholder, *image)) || !sprite.loadTexture(placeholder))
+	{
+		return false;
+	}
+
+	// a blank left from before the image changed size is written again
+	if (!fitsTexture(sprite, *image) &&
+		(fresh || !writeBlank(placeholder, *image) || !sprite.loadTexture(placeholder) ||
+		!fitsTexture(sprite, *image)))
+	{
+		return false;
+	}
+
+	ASGE::Texture2D* texture = const_cast<ASGE::Texture2D*>(sprite.getTexture());
+	texture->setData(const_cast<unsigned char*>(image->pixels));
+	uploads++;
+	return true;
+}
+
+std::string TextureCache::placeholderPath(const std::string& texture_file_name)
+{
+	size_t separator = texture_file_name.find_last_of("/\\");
+	size_t dot = texture_file_name.find_last_of('.');
+	if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+	{
+		dot = texture_file_name.size();
+	}
+
+	return texture_file_name.substr(0, dot) + ".blank.png";
+}
+
+void TextureCache::purge()
+{
+	for (auto it = entries.begin(); it != entries.end();)
+	{
+		it = it->second.expired() ? entries.erase(it) : ++it;
+	}
+}
+
+int TextureCache::size() const
+{
+	int live = 0;
+	for (const auto& entry : entries)
+	{
+		live += entry.second.expired() ? 0 : 1;
+	}
+
+	return live;
+}
+
+int TextureCache::loadCount() const
+{
+	return loads;
+}
+
+int TextureCache::uploadCount() const
+{
+	return uploads;
+}
+
+int TextureCache::hitCount() const
+{
+	return hits;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace ASGE
+{
+	class Renderer;
+	class Sprite;
+}
+
+class AssetLoader;
+
+/**
+*  Loads each texture file once and shares it.
+*  ASGE only creates a texture by loading it into a sprite, and a
+*  sprite can't be pointed at another sprite's texture. So the cache
+*  shares the loaded sprite itself, and users move it into place just
+*  before each draw. Entries are keyed by normalisePath, so
+*  ".\Resources\a.png" and "Resources/a.png" are the same texture.
+*  The cache only holds weak references. A texture is freed as soon
+*  as the last user lets go of it and is loaded again if it's asked
+*  for after that.
+*
+*  When an AssetLoader already holds a file's pixels, decoded or
+*  from the pack, the texture is made from a blank placeholder of
+*  the same size instead, written next to the file on first use, and
+*  the pixels are uploaded over it with Texture2D::setData. ASGE
+*  still decodes the placeholder, but a blank one is a few kilobytes
+*  of zeros and inflates in about half the time of a real image.
+*/
+class TextureCache
+{
+public:
+	explicit TextureCache(ASGE::Renderer* renderer = nullptr);
+
+	TextureCache(const TextureCache&) = delete;
+	TextureCache& operator=(const TextureCache&) = delete;
+
+	void setRenderer(ASGE::Renderer* renderer);
+
+	/**
+	*  Sets where pixels already in memory are looked for.
+	*  @param [in] loader A finished loader that outlives the cache,
+	*  or nullptr to always load textures from their files.
+	*/
+	void setImages(const AssetLoader* loader);
+
+	/**
+	*  Returns the sprite for a texture file, loading it on first use.
+	*  @param [in] texture_file_name The file path of the texture.
+	*  @return the shared sprite, or nullptr if the file couldn't be loaded.
+	*/
+	std::shared_ptr<ASGE::Sprite> load(const std::string& texture_file_name);
+
+	/**
+	*  Forgets entries whose texture has been freed.
+	*/
+	void purge();
+
+	int size() const;          /**< Textures currently loaded. */
+	int loadCount() const;     /**< Textures made since the cache was made. */
+	int uploadCount() const;   /**< How many of those were uploaded from memory. */
+	int hitCount() const;      /**< Requests served without making a texture. */
+
+	/**
+	*  The placeholder a texture file is swapped for, beside the file.
+	*/
+	static std::string placeholderPath(const std::string& texture_file_name);
+
+private:
+	bool loadFromMemory(ASGE::Sprite& sprite, const std::string& texture_file_name);
+
+	ASGE::Renderer* renderer = nullptr;
+	const AssetLoader* images = nullptr;
+	std::unordered_map<std::string, std::weak_ptr<ASGE::Sprite>> entries;
+	int loads = 0;
+	int uploads = 0;
+	int hits = 0;
+};
@@ -0,0 +1,97 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads)
+{
+	if (threads <= 0)
+	{
+		threads = static_cast<int>(std::thread::hardware_concurrency());
+	}
+
+	thread_count = threads > 0 ? threads : 1;
+	for (int i = 1; i < thread_count; i++)
+	{
+		workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	wake.notify_all();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+int ThreadPool::size() const
+{
+	return thread_count;
+}
+
+void ThreadPool::parallelFor(int count,
+	const std::function<void(int begin, int end, int chunk)>& job)
+{
+	if (thread_count == 1)
+	{
+		job(0, count, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		current_job = &job;
+		current_count = count;
+		pending = thread_count - 1;
+		job_generation++;
+	}
+
+	wake.notify_all();
+	runChunk(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return pending == 0; });
+	current_job = nullptr;
+}
+
+void ThreadPool::workerLoop(int chunk)
+{
+	unsigned seen = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this, seen] { return stopping || job_generation != seen; });
+			if (stopping)
+			{
+				return;
+			}
+			seen = job_generation;
+		}
+
+		runChunk(chunk);
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			last = --pending == 0;
+		}
+
+		if (last)
+		{
+			done.notify_one();
+		}
+	}
+}
+
+void ThreadPool::runChunk(int chunk)
+{
+	long long count = current_count;
+	int begin = static_cast<int>(count * chunk / thread_count);
+	int end = static_cast<int>(count * (chunk + 1) / thread_count);
+	(*current_job)(begin, end, chunk);
+}
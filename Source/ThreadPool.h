@@ -0,0 +1,58 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+*  A fixed set of worker threads for splitting a loop across cores.
+*  The threads are started once and sleep between jobs, so handing
+*  out work every tick costs a wake up rather than a thread start.
+*  The calling thread does a share of the work too.
+*/
+class ThreadPool
+{
+public:
+	/**
+	*  Starts the workers.
+	*  @param [in] threads How many threads work on each job, including
+	*  the caller. 0 uses one per hardware thread.
+	*/
+	explicit ThreadPool(int threads = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	*  The number of threads that work on each job.
+	*/
+	int size() const;
+
+	/**
+	*  Splits a range into one chunk per thread and waits for them all.
+	*  Chunk boundaries only depend on count and size(), never on
+	*  which thread finishes first.
+	*  @param [in] count The number of items to process.
+	*  @param [in] job Called once per chunk with the first item, one
+	*  past the last item and the chunk index.
+	*/
+	void parallelFor(int count, const std::function<void(int begin, int end, int chunk)>& job);
+
+private:
+	void workerLoop(int chunk);
+	void runChunk(int chunk);
+
+	std::vector<std::thread> workers;
+	std::mutex              mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	const std::function<void(int, int, int)>* current_job = nullptr;
+	int      current_count = 0;
+	int      thread_count = 1;
+	int      pending = 0;
+	unsigned job_generation = 0;
+	bool     stopping = false;
+};
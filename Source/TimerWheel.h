@@ -0,0 +1,358 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+/**
+*  Refers to a timer in a TimerWheel.
+*  Carries a generation, so cancelling a timer that has already
+*  fired, or been cancelled, does nothing.
+*/
+struct TimerId
+{
+	uint32_t index = 0;
+	uint32_t generation = 0;
+};
+
+/**
+*  A hierarchical timer wheel counting whole ticks.
+*  Timers are kept in four wheels of 64 slots, each wheel covering 64
+*  times the span of the one below, and one overflow list for timers
+*  further out than that. A timer goes into the lowest wheel whose
+*  span covers its delay and is moved down a wheel each time the
+*  wheel above turns over, so scheduling and cancelling are O(1)
+*  and a timer is touched at most four times before it fires. Every
+*  slot is a linked list threaded through one array of nodes, and a
+*  bitmask per wheel marks the slots in use, so advancing past empty
+*  slots skips straight over them. Timers carry a plain value rather
+*  than a callback, so the wheel can be copied along with its owner.
+*  @tparam T The value handed back when a timer fires.
+*/
+template <typename T>
+class TimerWheel
+{
+public:
+	TimerWheel()
+	{
+		for (int i = 0; i <= firing; i++)
+		{
+			heads[i] = none;
+			tails[i] = none;
+		}
+	}
+
+	/**
+	*  Starts a timer.
+	*  @param [in] delay Ticks from now. Timers due now or in the past
+	*  fire on the next tick.
+	*  @param [in] value Handed back when the timer fires.
+	*  @return an id that can be used to cancel the timer.
+	*/
+	TimerId schedule(uint64_t delay, const T& value)
+	{
+		uint32_t index;
+		if (free_nodes.empty())
+		{
+			index = static_cast<uint32_t>(nodes.size());
+			nodes.emplace_back();
+		}
+		else
+		{
+			index = free_nodes.back();
+			free_nodes.pop_back();
+		}
+
+		Node& node = nodes[index];
+		node.expiry = now + (delay > 0 ? delay : 1);
+		node.value = value;
+		node.active = true;
+		insert(index);
+		pending++;
+
+		TimerId id;
+		id.index = index;
+		id.generation = node.generation;
+		return id;
+	}
+
+	/**
+	*  Stops a timer before it fires.
+	*  @return false if the timer had already fired or been cancelled.
+	*/
+	bool cancel(TimerId id)
+	{
+		if (!isPending(id))
+		{
+			return false;
+		}
+
+		unlink(id.index);
+		release(id.index);
+		return true;
+	}
+
+	bool isPending(TimerId id) const
+	{
+		return id.index < nodes.size() && nodes[id.index].active &&
+			nodes[id.index].generation == id.generation;
+	}
+
+	/**
+	*  Moves the clock forward, firing every timer that falls due.
+	*  Timers fire in order of expiry. Timers sharing a tick fire in
+	*  an order that depends only on the calls made, so replays match,
+	*  but it isn't the order they were scheduled in. fire may schedule
+	*  and cancel timers, a new timer due before target fires in the
+	*  same call.
+	*  @param [in] ticks How far to move the clock.
+	*  @param [in] fire Called with each timer's value as it fires.
+	*/
+	template <typename F>
+	void advance(uint64_t ticks, F&& fire)
+	{
+		uint64_t target = now + ticks;
+		while (now < target)
+		{
+			if (pending == 0)
+			{
+				now = target;
+				break;
+			}
+
+			// jump over empty slots up to the end of this turn of the
+			// lowest wheel, where the wheels above have to be looked at
+			uint64_t turn_end = (now | (slots - 1)) + 1;
+			uint64_t stop = target < turn_end ? target : turn_end;
+			uint64_t next = nextUsed(now + 1, stop);
+			now = next;
+
+			if ((now & (slots - 1)) == 0)
+			{
+				cascade();
+			}
+
+			fireSlot(static_cast<int>(now & (slots - 1)), fire);
+		}
+	}
+
+	/**
+	*  @return the tick a timer is due on, or 0 if it isn't pending.
+	*/
+	uint64_t expiry(TimerId id) const
+	{
+		return isPending(id) ? nodes[id.index].expiry : 0;
+	}
+
+	uint64_t clock() const { return now; }
+	int size() const { return pending; }
+
+private:
+	static const int levels = 4;
+	static const int slots = 64;
+	static const int bits = 6;
+	static const uint32_t none = 0xffffffff;
+	static const int overflow = levels * slots;  /**< The list for timers beyond the top wheel. */
+	static const int firing = overflow + 1;      /**< Holds a slot's timers while they fire. */
+
+	struct Node
+	{
+		uint64_t expiry = 0;
+		T        value = T();
+		uint32_t prev = none;
+		uint32_t next = none;
+		int      list = -1;
+		uint32_t generation = 1;
+		bool     active = false;
+	};
+
+	/**
+	*  Links a node into the slot for its expiry.
+	*/
+	void insert(uint32_t index)
+	{
+		uint64_t expiry = nodes[index].expiry;
+		uint64_t delta = expiry > now ? expiry - now : 0;
+
+		int list = overflow;
+		for (int level = 0; level < levels; level++)
+		{
+			if (delta < (uint64_t(1) << (bits * (level + 1))))
+			{
+				int slot = static_cast<int>((expiry >> (bits * level)) & (slots - 1));
+				list = level * slots + slot;
+				used[level] |= uint64_t(1) << slot;
+				break;
+			}
+		}
+
+		link(index, list);
+	}
+
+	void link(uint32_t index, int list)
+	{
+		Node& node = nodes[index];
+		node.list = list;
+		node.next = none;
+		node.prev = tails[list];
+		if (tails[list] != none)
+		{
+			nodes[tails[list]].next = index;
+		}
+		else
+		{
+			heads[list] = index;
+		}
+		tails[list] = index;
+	}
+
+	void unlink(uint32_t index)
+	{
+		Node& node = nodes[index];
+		int list = node.list;
+		if (node.prev != none)
+		{
+			nodes[node.prev].next = node.next;
+		}
+		else
+		{
+			heads[list] = node.next;
+		}
+
+		if (node.next != none)
+		{
+			nodes[node.next].prev = node.prev;
+		}
+		else
+		{
+			tails[list] = node.prev;
+		}
+
+		if (list < overflow && heads[list] == none)
+		{
+			used[list / slots] &= ~(uint64_t(1) << (list % slots));
+		}
+		node.list = -1;
+	}
+
+	void release(uint32_t index)
+	{
+		Node& node = nodes[index];
+		node.active = false;
+		node.value = T();
+		node.generation = node.generation + 1 ? node.generation + 1 : 1;
+		free_nodes.push_back(index);
+		pending--;
+	}
+
+	/**
+	*  The first tick in [from, stop] whose lowest wheel slot is in
+	*  use, or stop if there isn't one. Both are in the same turn.
+	*/
+	uint64_t nextUsed(uint64_t from, uint64_t stop) const
+	{
+		if (from >= stop)
+		{
+			return stop;
+		}
+
+		int first = static_cast<int>(from & (slots - 1));
+		uint64_t mask = used[0] >> first;
+		if (mask == 0)
+		{
+			return stop;
+		}
+
+		int skip = 0;
+		while (!(mask & 1))
+		{
+			mask >>= 1;
+			skip++;
+		}
+
+		return from + skip < stop ? from + skip : stop;
+	}
+
+	/**
+	*  The lowest wheel has turned over, so the slots now due on the
+	*  wheels above are moved down, starting from the top so a timer
+	*  can drop more than one wheel at once.
+	*/
+	void cascade()
+	{
+		int top = 1;
+		while (top < levels && ((now >> (bits * top)) & (slots - 1)) == 0)
+		{
+			top++;
+		}
+
+		if (top == levels)
+		{
+			relink(overflow);
+		}
+
+		for (int level = (top < levels ? top : levels - 1); level >= 1; level--)
+		{
+			int slot = static_cast<int>((now >> (bits * level)) & (slots - 1));
+			relink(level * slots + slot);
+		}
+	}
+
+	/**
+	*  Takes every timer out of a list and inserts it again.
+	*/
+	void relink(int list)
+	{
+		uint32_t index = heads[list];
+		heads[list] = none;
+		tails[list] = none;
+		if (list < overflow)
+		{
+			used[list / slots] &= ~(uint64_t(1) << (list % slots));
+		}
+
+		while (index != none)
+		{
+			uint32_t next = nodes[index].next;
+			insert(index);
+			index = next;
+		}
+	}
+
+	template <typename F>
+	void fireSlot(int slot, F& fire)
+	{
+		if (heads[slot] == none)
+		{
+			return;
+		}
+
+		// moved aside first, so fire can schedule into this slot
+		// without the new timers firing a whole turn early
+		uint32_t index = heads[slot];
+		heads[slot] = none;
+		tails[slot] = none;
+		used[0] &= ~(uint64_t(1) << slot);
+		while (index != none)
+		{
+			uint32_t next = nodes[index].next;
+			link(index, firing);
+			index = next;
+		}
+
+		while (heads[firing] != none)
+		{
+			uint32_t fired = heads[firing];
+			unlink(fired);
+			T value = nodes[fired].value;
+			release(fired);
+			fire(value);
+		}
+	}
+
+	std::vector<Node>     nodes;
+	std::vector<uint32_t> free_nodes;
+	uint32_t heads[firing + 1];
+	uint32_t tails[firing + 1];
+	uint64_t used[levels] = {};    /**< Slots holding timers, one bit each. */
+	uint64_t now = 0;
+	int      pending = 0;
+};
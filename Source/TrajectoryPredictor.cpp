@@ -0,0 +1,115 @@
+#include <math.h>
+#include "ThreadPool.h"
+#include "TrajectoryPredictor.h"
+
+bool TrajectoryPredictor::predict(const Simulation& sim, int ball, BallTrace& out)
+{
+	scratch = sim;
+	return scratch.traceBall(ball, max_time, out);
+}
+
+/**
+*   @brief   Steers the paddle under the next ball to land.
+*   @details Every ball heading down is traced and the soonest to
+			 arrive is chased. The paddle stops once its centre is
+			 within a quarter of its width of the ball's centre.
+*   @return  The input to hold.
+*/
+SimInput TrajectoryPredictor::steer(const Simulation& sim, real& hold)
+{
+	const SimState& state = sim.state();
+	const SimConfig& config = sim.getConfig();
+
+	real ball_centre = state.balls[0].box.x + state.balls[0].box.length / 2;
+	bool found = false;
+	real soonest = 0;
+	for (int i = 0; i < static_cast<int>(state.balls.size()); i++)
+	{
+		if (state.balls[i].direction.y <= 0 || !predict(sim, i, trace))
+		{
+			continue;
+		}
+
+		if (!found || trace.time < soonest)
+		{
+			found = true;
+			soonest = trace.time;
+			ball_centre = trace.x + state.balls[i].box.length / 2;
+		}
+	}
+
+	SimInput input;
+	real offset = ball_centre - (state.paddle.x + state.paddle.length / 2);
+	real distance = absReal(offset);
+	real dead_zone = state.paddle.length / 4;
+	hold = config.event_horizon;
+	if (distance <= dead_zone)
+	{
+		return input;
+	}
+
+	input.paddle_left = offset < 0;
+	input.paddle_right = offset > 0;
+	if (config.paddle_velocity > 0)
+	{
+		hold = distance / config.paddle_velocity;
+	}
+
+	return input;
+}
+
+/**
+*   @brief   Plays one level from one launch angle.
+*   @details The predictor is asked for a new input whenever the last
+			 one runs out, or after a short step so it reacts to the
+			 ball's bounces.
+*   @return  How the run went.
+*/
+static LaunchResult playLaunch(const SimConfig& config, real angle,
+	real max_time, Simulation& sim, TrajectoryPredictor& predictor)
+{
+	// the game starts the ball off at {1, 1}, keep the same speed
+	double radians = toFloat(angle) * 3.14159265358979 / 180;
+	vec2 direction(static_cast<float>(cos(radians) * sqrt(2.0)),
+		static_cast<float>(-sin(radians) * sqrt(2.0)));
+
+	sim.init(config);
+	sim.launchBall(direction);
+
+	const real reaction = real(1) / 30;
+	while (!sim.isOver() && sim.state().elapsed_time < max_time)
+	{
+		real hold;
+		SimInput input = predictor.steer(sim, hold);
+		sim.advance(hold < reaction ? hold : reaction, input);
+	}
+
+	LaunchResult result;
+	result.angle = angle;
+	result.cleared = sim.isWon();
+	result.clear_time = sim.state().elapsed_time;
+	result.lives_lost = 3 - sim.state().player_life;
+	result.state_hash = sim.stateHash();
+	return result;
+}
+
+std::vector<LaunchResult> measureLaunchAngles(const SimConfig& config,
+	int angles, real max_time, int threads)
+{
+	std::vector<LaunchResult> results(angles > 0 ? angles : 0);
+	ThreadPool pool(threads);
+	std::vector<Simulation> sims(pool.size());
+	std::vector<TrajectoryPredictor> predictors(pool.size());
+
+	pool.parallelFor(static_cast<int>(results.size()),
+		[&](int begin, int end, int chunk)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			real angle = angles > 1 ? real(15) + real(150) * i / (angles - 1) : real(90);
+			results[i] = playLaunch(config, angle, max_time, sims[chunk], predictors[chunk]);
+		}
+	});
+
+	return results;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include "Scalar.h"
+#include "Simulation.h"
+
+/**
+*  Works out where the balls will come down.
+*  Each prediction runs a copy of the simulation forward with
+*  Simulation::traceBall, so it bounces off the walls, the ceiling
+*  and the live blocks by exactly the same rules as the game. The
+*  copy is kept between calls so its memory is reused. Used to steer
+*  a computer controlled paddle, and by measureLaunchAngles to play
+*  whole levels without a player.
+*/
+class TrajectoryPredictor
+{
+public:
+	/**
+	*  Traces one ball down to the paddle line.
+	*  @param [in] sim The simulation to predict, it isn't changed.
+	*  @param [in] ball The index of the ball to trace.
+	*  @param [out] trace Where and when the ball arrives, and the
+	*  blocks it destroys on the way.
+	*  @return false if the ball won't reach the line within max_time.
+	*/
+	bool predict(const Simulation& sim, int ball, BallTrace& trace);
+
+	/**
+	*  Chooses the paddle input that gets under the next ball to land.
+	*  The ball that will reach the paddle line first is traced, and
+	*  the paddle is moved to centre itself on where it comes down.
+	*  With nothing on its way down the paddle follows the first ball.
+	*  @param [in] sim The simulation to steer.
+	*  @param [out] hold How long the input can be held before the
+	*  paddle passes its target, in seconds.
+	*  @return the input for the paddle.
+	*/
+	SimInput steer(const Simulation& sim, real& hold);
+
+	real max_time = 10;   /**< Furthest ahead to look, in seconds. */
+
+private:
+	Simulation scratch;
+	BallTrace  trace;
+};
+
+/**
+*  How one launch angle played out.
+*/
+struct LaunchResult
+{
+	real angle = 0;          /**< Degrees anticlockwise from the right. */
+	bool cleared = false;    /**< Every block was destroyed. */
+	real clear_time = 0;     /**< Seconds of play until the level ended or time ran out. */
+	int  lives_lost = 0;
+	unsigned long long state_hash = 0;
+};
+
+/**
+*  Plays a level once for each of many launch angles.
+*  The paddle is steered by a TrajectoryPredictor, and every run
+*  starts from the same seed, so the spread of clear times shows how
+*  much the level depends on the opening shot. Runs are shared out
+*  across a thread pool, each thread with its own simulation and
+*  predictor, and the results don't depend on the thread count.
+*  @param [in] config The level to play.
+*  @param [in] angles How many angles to try, spread evenly between
+*  15 and 165 degrees.
+*  @param [in] max_time The longest to play each run for, in seconds.
+*  @param [in] threads Threads to play on, 0 for one per hardware thread.
+*  @return one result per angle, in angle order.
+*/
+std::vector<LaunchResult> measureLaunchAngles(const SimConfig& config,
+	int angles, real max_time, int threads = 0);
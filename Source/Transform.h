@@ -0,0 +1,34 @@
+#pragma once
+#include "Rect.h"
+#include "Vector2.h"
+
+/**
+*  Where an entity is and how big it is.
+*  Owned by the game rather than the engine's sprite, so reading it
+*  is a plain load that the compiler can inline. The position and
+*  size are stored as the object's bounding box, so the box never
+*  has to be built on request.
+*  @see EntityStore
+*/
+class Transform
+{
+public:
+	vec2 position() const { return vec2(box.x, box.y); }
+	vec2 size() const { return vec2(box.length, box.height); }
+	const rect& bounds() const { return box; }
+
+	void setPosition(vec2 position)
+	{
+		box.x = position.x;
+		box.y = position.y;
+	}
+
+	void setSize(vec2 size)
+	{
+		box.length = size.x;
+		box.height = size.y;
+	}
+
+private:
+	rect box;
+};
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include "UniformGrid.h"
+
+void UniformGrid::resize(const rect& bounds, real width, real height)
+{
+	area = bounds;
+	cell_width = width > 0 ? width : 1;
+	cell_height = height > 0 ? height : 1;
+	columns = static_cast<int>(area.length / cell_width) + 1;
+	rows = static_cast<int>(area.height / cell_height) + 1;
+
+	cells.assign(columns * rows, std::vector<int>());
+	entries.clear();
+	stamps.clear();
+	query_stamp = 0;
+}
+
+void UniformGrid::clear()
+{
+	for (auto& cell : cells)
+	{
+		cell.clear();
+	}
+
+	for (auto& entry : entries)
+	{
+		entry.clear();
+	}
+}
+
+/**
+*   @brief   Adds an object to every cell its bounds touch.
+*   @return  void
+*/
+void UniformGrid::insert(int id, const rect& bounds)
+{
+	if (id < 0 || cells.empty())
+	{
+		return;
+	}
+
+	if (id >= static_cast<int>(entries.size()))
+	{
+		entries.resize(id + 1);
+		stamps.resize(id + 1, 0);
+	}
+
+	remove(id);
+
+	int x0 = column(bounds.x);
+	int x1 = column(bounds.x + bounds.length);
+	int y0 = row(bounds.y);
+	int y1 = row(bounds.y + bounds.height);
+
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			int cell = y * columns + x;
+			CellRef ref{ cell, static_cast<int>(cells[cell].size()) };
+			cells[cell].push_back(id);
+			entries[id].push_back(ref);
+		}
+	}
+}
+
+/**
+*   @brief   Removes an object from the cells it was listed in.
+*   @details Each cell entry is swapped with the last one in the cell,
+			 so removal never shifts the rest of the cell.
+*   @return  void
+*/
+void UniformGrid::remove(int id)
+{
+	if (id < 0 || id >= static_cast<int>(entries.size()))
+	{
+		return;
+	}
+
+	for (const CellRef& ref : entries[id])
+	{
+		std::vector<int>& cell = cells[ref.cell];
+		int moved = cell.back();
+		cell[ref.slot] = moved;
+		cell.pop_back();
+
+		if (moved != id)
+		{
+			for (CellRef& moved_ref : entries[moved])
+			{
+				if (moved_ref.cell == ref.cell)
+				{
+					moved_ref.slot = ref.slot;
+					break;
+				}
+			}
+		}
+	}
+
+	entries[id].clear();
+}
+
+void UniformGrid::query(const rect& search, std::vector<int>& results) const
+{
+	results.clear();
+	if (cells.empty())
+	{
+		return;
+	}
+
+	// a new stamp means nothing has been reported yet by this query
+	if (++query_stamp == 0)
+	{
+		stamps.assign(stamps.size(), 0);
+		query_stamp = 1;
+	}
+
+	int x0 = column(search.x);
+	int x1 = column(search.x + search.length);
+	int y0 = row(search.y);
+	int y1 = row(search.y + search.height);
+
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			for (int id : cells[y * columns + x])
+			{
+				if (stamps[id] != query_stamp)
+				{
+					stamps[id] = query_stamp;
+					results.push_back(id);
+				}
+			}
+		}
+	}
+}
+
+void UniformGrid::queryConcurrent(const rect& search, std::vector<int>& results) const
+{
+	results.clear();
+	if (cells.empty())
+	{
+		return;
+	}
+
+	int x0 = column(search.x);
+	int x1 = column(search.x + search.length);
+	int y0 = row(search.y);
+	int y1 = row(search.y + search.height);
+
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			const std::vector<int>& cell = cells[y * columns + x];
+			results.insert(results.end(), cell.begin(), cell.end());
+		}
+	}
+
+	if (x0 != x1 || y0 != y1)
+	{
+		std::sort(results.begin(), results.end());
+		results.erase(std::unique(results.begin(), results.end()), results.end());
+	}
+}
+
+int UniformGrid::column(real x) const
+{
+	int c = static_cast<int>((x - area.x) / cell_width);
+	return c < 0 ? 0 : (c >= columns ? columns - 1 : c);
+}
+
+int UniformGrid::row(real y) const
+{
+	int r = static_cast<int>((y - area.y) / cell_height);
+	return r < 0 ? 0 : (r >= rows ? rows - 1 : r);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include "Broadphase.h"
+
+/**
+*  A broadphase made of equally sized cells.
+*  Every object is listed in each cell its bounds touch, so a query
+*  only visits the cells under the search area. This suits the
+*  block field well, as blocks are all the same size and sit on a
+*  regular grid. Objects outside the grid are kept in the nearest
+*  border cell.
+*  @see Broadphase
+*/
+class UniformGrid : public Broadphase
+{
+public:
+	/**
+	*  Sets the area covered by the grid and the size of the cells.
+	*  Any objects already inserted are removed.
+	*  @param [in] bounds The world area the grid covers.
+	*  @param [in] cell_width The width of a cell.
+	*  @param [in] cell_height The height of a cell.
+	*/
+	void resize(const rect& bounds, real cell_width, real cell_height);
+
+	virtual void clear() override;
+	virtual void insert(int id, const rect& bounds) override;
+	virtual void remove(int id) override;
+	virtual void query(const rect& area, std::vector<int>& results) const override;
+
+	/**
+	*  The same as query, but safe to call from several threads at once.
+	*  Duplicates are removed by sorting the results rather than with
+	*  the shared stamps. Areas within one cell can't hold duplicates
+	*  and skip the sort, so their ids come back in the cell's order.
+	*/
+	void queryConcurrent(const rect& area, std::vector<int>& results) const;
+
+private:
+	struct CellRef
+	{
+		int cell;
+		int slot;
+	};
+
+	int  column(real x) const;
+	int  row(real y) const;
+
+	rect  area;
+	real cell_width = 1;
+	real cell_height = 1;
+	int   columns = 0;
+	int   rows = 0;
+
+	std::vector<std::vector<int>>     cells;
+	std::vector<std::vector<CellRef>> entries;  /**< Where each id is stored, indexed by id. */
+	mutable std::vector<unsigned int> stamps;   /**< Last query that reported each id. */
+	mutable unsigned int query_stamp = 0;
+};
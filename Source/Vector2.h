@@ -1,21 +1,170 @@
 #pragma once
-struct vector2
+#include "Scalar.h"
+
+#if !defined(BREAKOUT_FIXED_POINT) && \
+	(defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#define VEC2_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/**
+*  A two component vector.
+*  Header only and trivially copyable, so it can be stored in plain
+*  arrays, memcpy'd and passed by value at no cost. Every operation
+*  is inline, and constexpr where the maths allows it.
+*/
+struct vec2
+{
+	real x = 0;
+	real y = 0;
+
+	constexpr vec2() = default;
+	constexpr vec2(real x_, real y_) : x(x_), y(y_) {}
+
+	constexpr vec2 operator-() const { return vec2(-x, -y); }
+
+	vec2& operator+=(vec2 rhs) { x += rhs.x; y += rhs.y; return *this; }
+	vec2& operator-=(vec2 rhs) { x -= rhs.x; y -= rhs.y; return *this; }
+	vec2& operator*=(real scalar) { x *= scalar; y *= scalar; return *this; }
+	vec2& operator/=(real scalar) { x /= scalar; y /= scalar; return *this; }
+};
+
+constexpr vec2 operator+(vec2 a, vec2 b) { return vec2(a.x + b.x, a.y + b.y); }
+constexpr vec2 operator-(vec2 a, vec2 b) { return vec2(a.x - b.x, a.y - b.y); }
+constexpr vec2 operator*(vec2 v, real scalar) { return vec2(v.x * scalar, v.y * scalar); }
+constexpr vec2 operator*(real scalar, vec2 v) { return vec2(v.x * scalar, v.y * scalar); }
+constexpr vec2 operator/(vec2 v, real scalar) { return vec2(v.x / scalar, v.y / scalar); }
+constexpr bool operator==(vec2 a, vec2 b) { return a.x == b.x && a.y == b.y; }
+constexpr bool operator!=(vec2 a, vec2 b) { return !(a == b); }
+
+constexpr real dot(vec2 a, vec2 b) { return a.x * b.x + a.y * b.y; }
+constexpr real lengthSquared(vec2 v) { return dot(v, v); }
+inline real length(vec2 v) { return sqrtReal(dot(v, v)); }
+
+/**
+*  Scales a vector to a length of one.
+*  A zero vector is returned unchanged.
+*/
+inline vec2 normalise(vec2 v)
+{
+	real magnitude = length(v);
+	return magnitude == 0 ? v : v / magnitude;
+}
+
+/**
+*  Mirrors a vector about a surface.
+*  @param [in] v The vector to reflect.
+*  @param [in] normal The surface normal, which must be unit length.
+*/
+constexpr vec2 reflect(vec2 v, vec2 normal)
+{
+	return v - normal * (2 * dot(v, normal));
+}
+
+/**
+*  Batch operations over arrays of vectors.
+*  Two vectors fit in an SSE register, so these work on pairs at a
+*  time where SSE2 is available and fall back to the inline
+*  functions above otherwise, including in fixed-point builds. No
+*  alignment is required.
+*/
+
+/**
+*  Adds a scaled copy of one array to another, out[i] += in[i] * scale.
+*  The usual way to move many objects along their velocities.
+*/
+inline void addScaled(vec2* out, const vec2* in, real scale, int count)
+{
+	int i = 0;
+#ifdef VEC2_SSE2
+	__m128 factor = _mm_set1_ps(scale);
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128 a = _mm_loadu_ps(&out[i].x);
+		__m128 b = _mm_loadu_ps(&in[i].x);
+		_mm_storeu_ps(&out[i].x, _mm_add_ps(a, _mm_mul_ps(b, factor)));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] += in[i] * scale;
+	}
+}
+
+/**
+*  Computes out[i] = dot(a[i], b[i]).
+*/
+inline void dotAll(const vec2* a, const vec2* b, real* out, int count)
+{
+	int i = 0;
+#ifdef VEC2_SSE2
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128 product = _mm_mul_ps(_mm_loadu_ps(&a[i].x), _mm_loadu_ps(&b[i].x));
+		// add each y to its x, giving the two dot products in lanes 0 and 2
+		__m128 sums = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+		out[i] = _mm_cvtss_f32(sums);
+		out[i + 1] = _mm_cvtss_f32(_mm_movehl_ps(sums, sums));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = dot(a[i], b[i]);
+	}
+}
+
+/**
+*  Normalises every vector in an array in place.
+*  Zero vectors are left unchanged.
+*/
+inline void normaliseAll(vec2* v, int count)
+{
+	int i = 0;
+#ifdef VEC2_SSE2
+	__m128 zero = _mm_setzero_ps();
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128 value = _mm_loadu_ps(&v[i].x);
+		__m128 squared = _mm_mul_ps(value, value);
+		__m128 sums = _mm_add_ps(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 3, 0, 1)));
+		__m128 lengths = _mm_sqrt_ps(sums);
+		__m128 scaled = _mm_div_ps(value, lengths);
+		__m128 is_zero = _mm_cmpeq_ps(lengths, zero);
+		_mm_storeu_ps(&v[i].x, _mm_or_ps(_mm_and_ps(is_zero, value), _mm_andnot_ps(is_zero, scaled)));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		v[i] = normalise(v[i]);
+	}
+}
+
+/**
+*  Reflects every vector in an array about the matching normal, but
+*  only those heading into their surface. Normals must be unit length.
+*/
+inline void reflectAll(vec2* v, const vec2* normals, int count)
 {
-	// construction
-	vector2(float x_vec_value, float y_vec_value_);
-	vector2(const vector2& rhs);
-	
-	// operations
-	vector2 operator*(float scalar);
-	void normalise();
-	
-	float get_x();
-	float get_y();
-
-	void x_set(float x_vec_val);
-	void y_set(float y_vec_val);
-
-private:
-	float x;
-	float y;
-};
\ No newline at end of file
+	int i = 0;
+#ifdef VEC2_SSE2
+	__m128 zero = _mm_setzero_ps();
+	__m128 two = _mm_set1_ps(2.0f);
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128 value = _mm_loadu_ps(&v[i].x);
+		__m128 normal = _mm_loadu_ps(&normals[i].x);
+		__m128 product = _mm_mul_ps(value, normal);
+		__m128 along = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+		__m128 into = _mm_cmplt_ps(along, zero);
+		__m128 reflected = _mm_sub_ps(value, _mm_mul_ps(normal, _mm_mul_ps(two, along)));
+		_mm_storeu_ps(&v[i].x, _mm_or_ps(_mm_and_ps(into, reflected), _mm_andnot_ps(into, value)));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		if (dot(v[i], normals[i]) < 0)
+		{
+			v[i] = reflect(v[i], normals[i]);
+		}
+	}
+}
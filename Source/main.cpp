@@ -1,13 +1,223 @@
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#include <stdio.h>
+#include <string.h>
 #include <Engine/Platform.h>
+#include "AllocAudit.h"
+#include "AssetLoader.h"
+#include "AssetPack.h"
+#include "AtlasBuilder.h"
 #include "Game.h"
+#include "Reports.h"
+
+/**
+*   @brief   Times the stress mode on increasing thread counts.
+*   @details Run with --stress, optionally followed by the number of
+			 balls. The results are written to stress_report.txt.
+*/
+static void runStressReport(const char* args)
+{
+	int balls = 0;
+	sscanf(args, "%*s %d", &balls);
+
+	FILE* report = fopen("stress_report.txt", "w");
+	if (report)
+	{
+		writeStressReport(report, balls);
+		fclose(report);
+	}
+}
+
+/**
+*   @brief   Plays the level from many launch angles.
+*   @details Run with --launch, optionally followed by the number of
+			 angles. Each run and a summary of the clear times are
+			 written to launch_report.txt.
+*/
+static void runLaunchReport(const char* args)
+{
+	int angles = 1000;
+	int requested = 0;
+	if (sscanf(args, "%*s %d", &requested) == 1 && requested > 0)
+	{
+		angles = requested;
+	}
+
+	FILE* report = fopen("launch_report.txt", "w");
+	if (report)
+	{
+		writeLaunchReport(report, angles);
+		fclose(report);
+	}
+}
+
+/**
+*   @brief   Packs a set of PNGs into a texture atlas.
+*   @details Run with --pack-atlas followed by a list file and the
+			 atlas to write. The list holds one PNG path per line and
+			 each sprite is named after its file. Pages are written
+			 next to the atlas, and a summary to atlas_report.txt.
+*/
+static void runAtlasPacker(const char* args)
+{
+	char list_path[260];
+	char atlas_path[260];
+	FILE* report = fopen("atlas_report.txt", "w");
+	if (!report)
+	{
+		return;
+	}
+
+	if (sscanf(args, "%*s %259s %259s", list_path, atlas_path) != 2)
+	{
+		fprintf(report, "usage: --pack-atlas <list file> <atlas file>\n");
+		fclose(report);
+		return;
+	}
+
+	FILE* list = fopen(list_path, "r");
+	if (!list)
+	{
+		fprintf(report, "can't open %s\n", list_path);
+		fclose(report);
+		return;
+	}
+
+	std::string atlas_name = TextureAtlas::spriteName(atlas_path);
+
+	AtlasBuilder builder;
+	char line[260];
+	int images = 0;
+	while (fscanf(list, "%259s", line) == 1)
+	{
+		std::string path = line;
+		Image image;
+		if (!loadPng(path, image))
+		{
+			fprintf(report, "skipped %s, not a readable PNG\n", line);
+			continue;
+		}
+
+		builder.add(TextureAtlas::spriteName(path), image);
+		images++;
+	}
+	fclose(list);
+
+	if (!builder.build(atlas_name) || !builder.save(atlas_path))
+	{
+		fprintf(report, "failed to build %s\n", atlas_path);
+		fclose(report);
+		return;
+	}
+
+	fprintf(report, "%d images on %d pages\n", images, builder.atlas().pageCount());
+	for (const Image& page : builder.pages())
+	{
+		fprintf(report, "  %d x %d\n", page.width, page.height);
+	}
+	fclose(report);
+}
+
+/**
+*   @brief   Writes an asset pack for a manifest.
+*   @details Run with --pack-assets followed by the manifest and the
+			 pack to write. Every image the manifest loads is decoded,
+			 ignoring any pack it lists, and the pack is read back and
+			 verified once written. A summary goes to pack_report.txt.
+*/
+static void runAssetPacker(const char* args)
+{
+	char manifest_path[260];
+	char pack_path[260];
+	FILE* report = fopen("pack_report.txt", "w");
+	if (!report)
+	{
+		return;
+	}
+
+	AssetManifest manifest;
+	if (sscanf(args, "%*s %259s %259s", manifest_path, pack_path) != 2 ||
+		!manifest.load(manifest_path))
+	{
+		fprintf(report, "usage: --pack-assets <manifest> <pack file>\n");
+		fclose(report);
+		return;
+	}
+
+	AssetManifest unpacked;
+	for (const AssetEntry& entry : manifest.entries())
+	{
+		if (entry.type != AssetEntry::Type::PACK)
+		{
+			unpacked.add(entry.type, entry.name, entry.path);
+		}
+	}
+
+	AssetLoader loader;
+	bool loaded = loader.start(unpacked).get();
+
+	AssetPackBuilder builder;
+	for (const std::string& file : loader.fileList())
+	{
+		const ImageView* image = loader.image(file);
+		if (image)
+		{
+			builder.add(file, *image);
+			fprintf(report, "  %d x %d %s\n", image->width, image->height, file.c_str());
+		}
+		else
+		{
+			fprintf(report, "skipped %s, not a readable PNG\n", file.c_str());
+		}
+	}
+
+	AssetPack pack;
+	if (!builder.save(pack_path) || !pack.open(pack_path) || !pack.verify())
+	{
+		fprintf(report, "failed to write %s\n", pack_path);
+	}
+	else
+	{
+		fprintf(report, "%d images packed%s\n", pack.size(), loaded ? "" : ", some files missing");
+	}
+	fclose(report);
+}
 
 int WINAPI WinMain(
 	HINSTANCE hInstance, 
 	HINSTANCE hPrevInstance, 
 	PSTR pScmdline, int iCmdshow)
 {
+	if (pScmdline && strstr(pScmdline, "--stress"))
+	{
+		runStressReport(strstr(pScmdline, "--stress"));
+		return 0;
+	}
+
+	if (pScmdline && strstr(pScmdline, "--launch"))
+	{
+		runLaunchReport(strstr(pScmdline, "--launch"));
+		return 0;
+	}
+
+	if (pScmdline && strstr(pScmdline, "--pack-atlas"))
+	{
+		runAtlasPacker(strstr(pScmdline, "--pack-atlas"));
+		return 0;
+	}
+
+	if (pScmdline && strstr(pScmdline, "--pack-assets"))
+	{
+		runAssetPacker(strstr(pScmdline, "--pack-assets"));
+		return 0;
+	}
+
+	// only does anything in BREAKOUT_ALLOC_AUDIT builds
+	if (pScmdline && strstr(pScmdline, "--alloc-strict"))
+	{
+		allocAuditFailOnViolation(true);
+	}
+
 	BreakoutGame* game = new BreakoutGame;
 	if (game->init())
 	{
@@ -16,4 +226,5 @@ int WINAPI WinMain(
 
 	delete game;
 	game = nullptr;
+	allocAuditReport("alloc_report.txt");
 }
\ No newline at end of file
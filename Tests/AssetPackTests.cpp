@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+#include "AssetPack.h"
+#include "PngCodec.h"
+#include "Tests.h"
+
+namespace
+{
+	Image makeImage(int width, int height, unsigned seed)
+	{
+		Image image;
+		image.resize(width, height);
+		for (size_t i = 0; i < image.pixels.size(); i++)
+		{
+			seed = seed * 1103515245u + 12345u;
+			image.pixels[i] = static_cast<unsigned char>(seed >> 16);
+		}
+		return image;
+	}
+
+	ImageView view(const Image& image)
+	{
+		ImageView view;
+		view.width = image.width;
+		view.height = image.height;
+		view.pixels = image.pixels.data();
+		return view;
+	}
+
+	bool matches(const ImageView& found, const Image& image)
+	{
+		return found.width == image.width && found.height == image.height &&
+			!memcmp(found.pixels, image.pixels.data(), image.pixels.size());
+	}
+
+	/**
+	*  Moves a file's modification time, as an edit would.
+	*/
+	bool touch(const std::string& path, long long seconds)
+	{
+#ifdef _WIN32
+		struct _utimbuf times;
+		times.actime = static_cast<time_t>(seconds);
+		times.modtime = static_cast<time_t>(seconds);
+		return _utime(path.c_str(), &times) == 0;
+#else
+		struct utimbuf times;
+		times.actime = static_cast<time_t>(seconds);
+		times.modtime = static_cast<time_t>(seconds);
+		return utime(path.c_str(), &times) == 0;
+#endif
+	}
+
+	/**
+	*  Packs one image with a source file on disk and one without,
+	*  then reads both back through the mapping. Paths are looked up
+	*  by their normalised form, anything else misses.
+	*/
+	void testRoundTrip()
+	{
+		std::string source = testOutputPath("pack_source.png");
+		std::string pack_path = testOutputPath("round_trip.bpak");
+		Image on_disk = makeImage(7, 5, 1);
+		Image packed_only = makeImage(16, 3, 2);
+		CHECK(savePng(source, on_disk));
+
+		AssetPackBuilder builder;
+		builder.add(source, view(makeImage(7, 5, 3)));
+		builder.add(source, view(on_disk));
+		builder.add("Resources/missing/only_in_pack.png", view(packed_only));
+		CHECK(builder.save(pack_path));
+
+		AssetPack pack;
+		if (!CHECK(pack.open(pack_path)))
+		{
+			return;
+		}
+
+		CHECK(pack.size() == 2);
+		CHECK(pack.verify());
+
+		ImageView found;
+		CHECK(pack.find(source, found) && matches(found, on_disk));
+		CHECK(reinterpret_cast<uintptr_t>(found.pixels) % 16 == 0);
+		CHECK(pack.find("Resources/missing/only_in_pack.png", found) && matches(found, packed_only));
+		CHECK(pack.find("./Resources/x/../missing/only_in_pack.png", found) && matches(found, packed_only));
+
+		CHECK(!pack.find("Resources/missing/other.png", found));
+		CHECK(!pack.find("Resources/missing", found));
+		CHECK(!pack.find("", found));
+
+		pack.close();
+		CHECK(!pack.isOpen());
+		CHECK(!pack.find(source, found));
+		remove(pack_path.c_str());
+		remove(source.c_str());
+	}
+
+	/**
+	*  An entry is dropped once its source no longer matches the size
+	*  and time it was packed with.
+	*/
+	void testStaleStamp()
+	{
+		std::string source = testOutputPath("stale_source.png");
+		std::string pack_path = testOutputPath("stale.bpak");
+		Image image = makeImage(4, 4, 4);
+		CHECK(savePng(source, image));
+		CHECK(touch(source, 1000000000));
+
+		AssetPackBuilder builder;
+		builder.add(source, view(image));
+		CHECK(builder.save(pack_path));
+
+		AssetPack pack;
+		if (!CHECK(pack.open(pack_path)))
+		{
+			return;
+		}
+
+		ImageView found;
+		CHECK(pack.find(source, found));
+		CHECK(touch(source, 1000000060));
+		CHECK(!pack.find(source, found));
+		CHECK(touch(source, 1000000000));
+		CHECK(pack.find(source, found));
+
+		CHECK(savePng(source, makeImage(5, 4, 5)));
+		CHECK(touch(source, 1000000000));
+		CHECK(!pack.find(source, found));
+
+		pack.close();
+		remove(pack_path.c_str());
+		remove(source.c_str());
+	}
+
+	/**
+	*  Files that aren't packs, or are cut short, are refused when
+	*  opened, and a damaged image fails verify().
+	*/
+	void testDamagedPacks()
+	{
+		std::string pack_path = testOutputPath("damaged.bpak");
+		AssetPack pack;
+		CHECK(!pack.open(testOutputPath("no_such.bpak")));
+		CHECK(!pack.open(testDataPath("rgba8.png")));
+
+		AssetPackBuilder builder;
+		builder.add("damaged.png", view(makeImage(8, 8, 6)));
+		CHECK(builder.save(pack_path));
+
+		std::string bytes;
+		FILE* file = fopen(pack_path.c_str(), "rb");
+		if (!CHECK(file != nullptr))
+		{
+			return;
+		}
+		char buffer[4096];
+		size_t read;
+		while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		{
+			bytes.append(buffer, read);
+		}
+		fclose(file);
+
+		file = fopen(pack_path.c_str(), "wb");
+		fwrite(bytes.data(), 1, bytes.size() - 1, file);
+		fclose(file);
+		CHECK(!pack.open(pack_path));
+
+		bytes[bytes.size() - 1] ^= 1;
+		file = fopen(pack_path.c_str(), "wb");
+		fwrite(bytes.data(), 1, bytes.size(), file);
+		fclose(file);
+		CHECK(pack.open(pack_path));
+		CHECK(!pack.verify());
+
+		pack.close();
+		remove(pack_path.c_str());
+	}
+}
+
+void runAssetPackTests()
+{
+	testRoundTrip();
+	testStaleStamp();
+	testDamagedPacks();
+}
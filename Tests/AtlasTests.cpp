@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "AtlasBuilder.h"
+#include "Tests.h"
+
+namespace
+{
+	const int page_size = 128;
+	const int padding = 2;
+
+	Image makeImage(int width, int height, unsigned seed)
+	{
+		Image image;
+		image.resize(width, height);
+		for (size_t i = 0; i < image.pixels.size(); i++)
+		{
+			seed = seed * 1103515245u + 12345u;
+			image.pixels[i] = static_cast<unsigned char>(seed >> 16);
+		}
+		return image;
+	}
+
+	/**
+	*  The region must hold the source exactly, with the border around
+	*  it copied from the nearest edge pixel.
+	*/
+	bool regionMatches(const Image& page, const AtlasRegion& region, const Image& source)
+	{
+		for (int y = -padding; y < region.height + padding; y++)
+		{
+			for (int x = -padding; x < region.width + padding; x++)
+			{
+				int sx = std::min(std::max(x, 0), source.width - 1);
+				int sy = std::min(std::max(y, 0), source.height - 1);
+				if (memcmp(page.pixel(region.x + x, region.y + y), source.pixel(sx, sy), 4))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool overlaps(const AtlasRegion& a, const AtlasRegion& b)
+	{
+		return a.page == b.page &&
+			a.x - padding < b.x + b.width + padding && b.x - padding < a.x + a.width + padding &&
+			a.y - padding < b.y + b.height + padding && b.y - padding < a.y + a.height + padding;
+	}
+
+	/**
+	*  Packs sprites of mixed sizes over several pages. Every sprite
+	*  must come back with its own pixels, its border inside the page
+	*  once the page has been trimmed, and no two sprites or borders
+	*  sharing a pixel.
+	*/
+	void testBuild()
+	{
+		AtlasBuilder builder(page_size, padding);
+		std::vector<Image> sources;
+		std::vector<std::string> names;
+		unsigned seed = 5;
+		for (int i = 0; i < 60; i++)
+		{
+			seed = seed * 1103515245u + 12345u;
+			int width = 1 + static_cast<int>((seed >> 8) % 40);
+			int height = 1 + static_cast<int>((seed >> 20) % 30);
+			sources.push_back(makeImage(width, height, seed));
+			names.push_back("sprite" + std::to_string(i));
+			builder.add(names.back(), sources.back());
+		}
+
+		if (!CHECK(builder.build("test_atlas")))
+		{
+			return;
+		}
+
+		const TextureAtlas& atlas = builder.atlas();
+		CHECK(atlas.regionCount() == 60);
+		CHECK(atlas.pageCount() > 1);
+		CHECK(atlas.pageCount() == static_cast<int>(builder.pages().size()));
+
+		bool found = true;
+		bool inside = true;
+		bool matched = true;
+		bool separate = true;
+		std::vector<AtlasRegion> regions;
+		for (size_t i = 0; i < sources.size(); i++)
+		{
+			const AtlasRegion* region = atlas.find(names[i]);
+			found = found && region && region->width == sources[i].width &&
+				region->height == sources[i].height;
+			if (!region)
+			{
+				continue;
+			}
+
+			bool in_page = region->page >= 0 && region->page < atlas.pageCount() &&
+				region->x - padding >= 0 && region->y - padding >= 0 &&
+				region->x + region->width + padding <= builder.pages()[region->page].width &&
+				region->y + region->height + padding <= builder.pages()[region->page].height;
+			inside = inside && in_page;
+			matched = matched && in_page && regionMatches(builder.pages()[region->page], *region, sources[i]);
+
+			for (const AtlasRegion& other : regions)
+			{
+				separate = separate && !overlaps(*region, other);
+			}
+			regions.push_back(*region);
+		}
+
+		CHECK(found);
+		CHECK(inside);
+		CHECK(matched);
+		CHECK(separate);
+		CHECK(atlas.find("sprite60") == nullptr);
+	}
+
+	/**
+	*  An image bigger than a page, border included, can't be packed.
+	*/
+	void testTooBig()
+	{
+		AtlasBuilder builder(page_size, padding);
+		builder.add("fits", makeImage(page_size - padding * 2, 8, 1));
+		CHECK(builder.build("fits"));
+
+		builder.add("wide", makeImage(page_size - padding * 2 + 1, 8, 2));
+		CHECK(!builder.build("wide"));
+	}
+
+	/**
+	*  Saving writes the pages and atlas file, and loading the file back
+	*  gives the same regions, with page paths beside the atlas file.
+	*/
+	void testSaveLoad()
+	{
+		AtlasBuilder builder(page_size, padding);
+		builder.add("a", makeImage(30, 20, 3));
+		builder.add("b", makeImage(12, 40, 4));
+		if (!CHECK(builder.build("saved_atlas")))
+		{
+			return;
+		}
+
+		std::string path = testOutputPath("saved_atlas.txt");
+		CHECK(builder.save(path));
+
+		TextureAtlas loaded;
+		CHECK(loaded.load(path));
+		CHECK(loaded.pageCount() == builder.atlas().pageCount());
+		CHECK(loaded.regionCount() == 2);
+		for (const char* name : { "a", "b" })
+		{
+			const AtlasRegion* saved = builder.atlas().find(name);
+			const AtlasRegion* read = loaded.find(name);
+			CHECK(saved && read && saved->page == read->page && saved->x == read->x &&
+				saved->y == read->y && saved->width == read->width && saved->height == read->height);
+		}
+
+		Image page;
+		std::string page_path = loaded.pagePath(0);
+		CHECK(page_path == testOutputPath("saved_atlas_0.png"));
+		CHECK(loadPng(page_path, page) && page.pixels == builder.pages()[0].pixels);
+
+		remove(page_path.c_str());
+		remove(path.c_str());
+		CHECK(!loaded.load(path));
+		CHECK(TextureAtlas::spriteName("Resources/Textures/puzzlepack/png/ballBlue.png") == "ballBlue");
+	}
+}
+
+void runAtlasTests()
+{
+	testBuild();
+	testTooBig();
+	testSaveLoad();
+}
@@ -0,0 +1,151 @@
+# Writes the PNG fixtures used by Tests/PngTests.cpp, each with the RGBA
+# it should decode to. The expected pixels are worked out here from the
+# PNG specification, not by the decoder under test. Run from Tests/Data.
+import random
+import struct
+import zlib
+
+random.seed(25)
+
+
+def chunk(kind, body):
+    crc = zlib.crc32(kind + body) & 0xffffffff
+    return struct.pack('>I', len(body)) + kind + body + struct.pack('>I', crc)
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def pack_row(samples, depth):
+    if depth == 16:
+        return b''.join(struct.pack('>H', s) for s in samples)
+    if depth == 8:
+        return bytes(samples)
+    out = bytearray()
+    per_byte = 8 // depth
+    for i in range(0, len(samples), per_byte):
+        byte = 0
+        for j in range(per_byte):
+            s = samples[i + j] if i + j < len(samples) else 0
+            byte |= s << (8 - depth * (j + 1))
+        out.append(byte)
+    return bytes(out)
+
+
+def filter_rows(rows, bpp):
+    # every row uses the next of the five filters in turn
+    out = bytearray()
+    prior = bytes(len(rows[0]))
+    for y, row in enumerate(rows):
+        kind = y % 5
+        out.append(kind)
+        for i in range(len(row)):
+            a = row[i - bpp] if i >= bpp else 0
+            b = prior[i]
+            c = prior[i - bpp] if i >= bpp else 0
+            predicted = [0, a, b, (a + b) // 2, paeth(a, b, c)][kind]
+            out.append((row[i] - predicted) & 0xff)
+        prior = row
+    return bytes(out)
+
+
+def to_8bit(sample, depth):
+    if depth == 16:
+        return sample >> 8
+    return sample * 255 // ((1 << depth) - 1)
+
+
+def make(name, width, height, colour_type, depth, level=6, split=0, palette=None, trns=None):
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[colour_type]
+    top = (1 << depth) - 1
+    if colour_type == 3:
+        top = len(palette) - 1
+
+    pixels = [[[random.randint(0, top) for _ in range(channels)] for _ in range(width)]
+              for _ in range(height)]
+    if trns is not None and colour_type in (0, 2):
+        # make sure the transparent colour turns up
+        pixels[0][0] = list(trns)
+
+    rows = [pack_row([s for p in row for s in p], depth) for row in pixels]
+    bpp = max(1, channels * depth // 8)
+    data = zlib.compress(filter_rows(rows, bpp), level)
+
+    png = b'\x89PNG\r\n\x1a\n'
+    png += chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, depth, colour_type, 0, 0, 0))
+    if palette:
+        png += chunk(b'PLTE', b''.join(bytes(c) for c in palette))
+    if trns is not None:
+        if colour_type == 3:
+            png += chunk(b'tRNS', bytes(trns))
+        else:
+            png += chunk(b'tRNS', b''.join(struct.pack('>H', s) for s in trns))
+    parts = [data[i:i + split] for i in range(0, len(data), split)] if split else [data]
+    for part in parts:
+        png += chunk(b'IDAT', part)
+    png += chunk(b'IEND', b'')
+
+    rgba = bytearray()
+    for row in pixels:
+        for p in row:
+            if colour_type == 0:
+                g = to_8bit(p[0], depth)
+                a = 0 if trns is not None and p == list(trns) else 255
+                rgba += bytes((g, g, g, a))
+            elif colour_type == 2:
+                a = 0 if trns is not None and p == list(trns) else 255
+                rgba += bytes([to_8bit(s, depth) for s in p] + [a])
+            elif colour_type == 3:
+                a = trns[p[0]] if trns is not None and p[0] < len(trns) else 255
+                rgba += bytes(list(palette[p[0]]) + [a])
+            elif colour_type == 4:
+                g = to_8bit(p[0], depth)
+                rgba += bytes((g, g, g, to_8bit(p[1], depth)))
+            else:
+                rgba += bytes(to_8bit(s, depth) for s in p)
+
+    open(name + '.png', 'wb').write(png)
+    open(name + '.rgba', 'wb').write(bytes(rgba))
+    return bytes(rgba)
+
+
+def premultiplied(rgba):
+    out = bytearray(rgba)
+    for i in range(0, len(out), 4):
+        for c in range(3):
+            out[i + c] = (rgba[i + c] * rgba[i + 3] + 127) // 255
+    return bytes(out)
+
+
+palette = [(random.randint(0, 255), random.randint(0, 255), random.randint(0, 255)) for _ in range(16)]
+
+make('grey1', 19, 6, 0, 1, trns=(1,))
+make('grey4', 11, 5, 0, 4)
+make('grey16', 7, 5, 0, 16, trns=(1234,))
+make('rgb8', 9, 7, 2, 8, trns=(10, 20, 30))
+make('rgb16', 5, 6, 2, 16)
+make('palette2', 13, 5, 3, 2, palette=palette[:4], trns=(0, 128))
+make('palette8', 8, 8, 3, 8, level=0, palette=palette, trns=(255, 64, 0))
+make('grey_alpha8', 6, 5, 4, 8)
+make('grey_alpha16', 5, 5, 4, 16)
+rgba = make('rgba8', 12, 10, 6, 8, split=7)
+make('rgba16', 4, 6, 6, 16, level=9)
+open('rgba8.premultiplied.rgba', 'wb').write(premultiplied(rgba))
+
+
+def header_only(name, width, height, data):
+    png = b'\x89PNG\r\n\x1a\n'
+    png += chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 6, 0, 0, 0))
+    png += chunk(b'IDAT', data)
+    png += chunk(b'IEND', b'')
+    open(name + '.png', 'wb').write(png)
+
+
+# headers claiming far more pixels than their data can fill
+header_only('huge_dimensions', 16777216, 16777216, b'\x78\x9c\x03')
+header_only('short_data', 8192, 8192, zlib.compress(b'\0' * 4097 * 4))
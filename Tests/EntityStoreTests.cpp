@@ -0,0 +1,222 @@
+#include <stdlib.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "EntityStore.h"
+#include "Tests.h"
+
+namespace
+{
+	struct Position { int x; };
+	struct Velocity { int dx; };
+	struct Name { std::string text; };
+
+	/**
+	*  What an entity should hold, kept beside the store to check it by.
+	*/
+	struct Expected
+	{
+		Entity entity;
+		bool alive = false;
+		bool has_position = false;
+		bool has_velocity = false;
+		bool has_name = false;
+		int x = 0;
+		int dx = 0;
+		std::string text;
+	};
+
+	bool holds(EntityStore& store, const Expected& expected)
+	{
+		if (store.isAlive(expected.entity) != expected.alive)
+		{
+			return false;
+		}
+
+		Position* position = store.get<Position>(expected.entity);
+		Velocity* velocity = store.get<Velocity>(expected.entity);
+		Name* name = store.get<Name>(expected.entity);
+		return (position != nullptr) == (expected.alive && expected.has_position) &&
+			(velocity != nullptr) == (expected.alive && expected.has_velocity) &&
+			(name != nullptr) == (expected.alive && expected.has_name) &&
+			(!position || position->x == expected.x) &&
+			(!velocity || velocity->dx == expected.dx) &&
+			(!name || name->text == expected.text);
+	}
+
+	/**
+	*  each() must visit every live entity with the components once,
+	*  and nothing else, handing over that entity's own components.
+	*/
+	bool eachCovers(EntityStore& store, const std::vector<Expected>& expected)
+	{
+		std::vector<int> visits(expected.size(), 0);
+		bool matched = true;
+		store.each<Position, Velocity>([&](Entity entity, Position& position, Velocity& velocity)
+		{
+			const Expected& e = expected[entity.index];
+			matched = matched && e.entity == entity && e.alive &&
+				e.has_position && e.has_velocity && position.x == e.x && velocity.dx == e.dx;
+			visits[entity.index]++;
+		});
+
+		int wanted = 0;
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			bool included = expected[i].alive && expected[i].has_position && expected[i].has_velocity;
+			wanted += included ? 1 : 0;
+			matched = matched && visits[i] == (included ? 1 : 0);
+		}
+
+		return matched && store.count<Position, Velocity>() == wanted;
+	}
+
+	/**
+	*  Random creates, destroys, adds and removes, each of which moves
+	*  rows between archetypes and fills the gaps they leave with the
+	*  last row. After every change the store must still agree with a
+	*  plain record of what each entity should have.
+	*/
+	void testAgainstModel()
+	{
+		EntityStore store;
+		std::vector<Expected> expected;
+		srand(17);
+
+		bool held = true;
+		bool covered = true;
+		for (int step = 0; step < 3000; step++)
+		{
+			int op = rand() % 6;
+			int value = rand() % 1000;
+			Expected* target = expected.empty() ? nullptr : &expected[rand() % expected.size()];
+			if (op == 0 || !target)
+			{
+				Entity entity;
+				switch (value % 3)
+				{
+				case 0: entity = store.create(Position{ value }); break;
+				case 1: entity = store.create(Position{ value }, Velocity{ -value }); break;
+				default: entity = store.create(Name{ std::to_string(value) }, Velocity{ -value }); break;
+				}
+
+				if (entity.index >= expected.size())
+				{
+					expected.resize(entity.index + 1);
+				}
+
+				Expected& e = expected[entity.index];
+				e = Expected();
+				e.entity = entity;
+				e.alive = true;
+				e.has_position = value % 3 != 2;
+				e.has_velocity = value % 3 != 0;
+				e.has_name = value % 3 == 2;
+				e.x = value;
+				e.dx = -value;
+				e.text = std::to_string(value);
+			}
+			else if (op == 1)
+			{
+				store.destroy(target->entity);
+				target->alive = false;
+			}
+			else if (op == 2)
+			{
+				bool added = store.add(target->entity, Velocity{ value }) != nullptr;
+				held = held && added == target->alive;
+				target->has_velocity = true;
+				target->dx = value;
+			}
+			else if (op == 3)
+			{
+				store.add(target->entity, Name{ std::to_string(value) });
+				target->has_name = true;
+				target->text = std::to_string(value);
+			}
+			else if (op == 4)
+			{
+				store.remove<Velocity>(target->entity);
+				target->has_velocity = false;
+			}
+			else
+			{
+				store.remove<Position>(target->entity);
+				target->has_position = false;
+			}
+
+			int alive = 0;
+			for (const Expected& e : expected)
+			{
+				held = held && holds(store, e);
+				alive += e.alive ? 1 : 0;
+			}
+			held = held && store.size() == alive;
+			covered = covered && eachCovers(store, expected);
+		}
+
+		CHECK(held);
+		CHECK(covered);
+		CHECK(store.size() > 0);
+	}
+
+	/**
+	*  A destroyed entity's handle stays dead after its slot is reused,
+	*  and changes through it are ignored.
+	*/
+	void testStaleEntities()
+	{
+		EntityStore store;
+		Entity first = store.create(Position{ 1 });
+		store.destroy(first);
+		Entity second = store.create(Position{ 2 });
+
+		CHECK(second.index == first.index);
+		CHECK(!store.isAlive(first));
+		CHECK(store.get<Position>(first) == nullptr);
+		CHECK(store.add(first, Velocity{ 3 }) == nullptr);
+		store.remove<Position>(first);
+		store.destroy(first);
+
+		CHECK(store.isAlive(second));
+		CHECK(store.get<Position>(second)->x == 2);
+		CHECK(store.get<Velocity>(second) == nullptr);
+		CHECK(store.size() == 1);
+		CHECK(!store.isAlive(Entity()));
+	}
+
+	/**
+	*  Components only need to be movable, and each is destroyed once
+	*  whether the entity is destroyed, loses it, or outlives the store.
+	*/
+	void testMoveOnlyComponents()
+	{
+		std::shared_ptr<int> counted = std::make_shared<int>(7);
+		{
+			EntityStore store;
+			std::vector<Entity> entities;
+			for (int i = 0; i < 40; i++)
+			{
+				entities.push_back(store.create(std::unique_ptr<std::shared_ptr<int>>(
+					new std::shared_ptr<int>(counted)), Position{ i }));
+			}
+			CHECK(counted.use_count() == 41);
+
+			store.destroy(entities[0]);
+			store.remove<std::unique_ptr<std::shared_ptr<int>>>(entities[1]);
+			store.add(entities[2], Velocity{ 0 });
+			CHECK(counted.use_count() == 39);
+			CHECK(**store.get<std::unique_ptr<std::shared_ptr<int>>>(entities[2]) == counted);
+			CHECK(store.get<Position>(entities[39])->x == 39);
+		}
+
+		CHECK(counted.use_count() == 1);
+	}
+}
+
+void runEntityStoreTests()
+{
+	testAgainstModel();
+	testStaleEntities();
+	testMoveOnlyComponents();
+}
@@ -0,0 +1,31 @@
+#include "Fixed.h"
+#include "Tests.h"
+
+namespace
+{
+	/**
+	*  Products and quotients well past 2^31 must neither overflow nor
+	*  change how they round.
+	*/
+	void testWideProducts()
+	{
+		fixed big(1 << 20);
+		CHECK((big * big).rawValue() == int64_t(1) << 56);
+		CHECK((-big * big).rawValue() == -(int64_t(1) << 56));
+		CHECK(((big * big) / big).rawValue() == big.rawValue());
+		CHECK(((big * big) / -big).rawValue() == -big.rawValue());
+
+		// both round towards negative infinity
+		fixed tiny = fixed::fromRaw(1);
+		fixed half = fixed(1) / fixed(2);
+		CHECK((tiny * half).rawValue() == 0);
+		CHECK((-tiny * half).rawValue() == -1);
+		CHECK((fixed(-1) / fixed(3)).rawValue() == -21846);
+		CHECK((fixed(1) / fixed(3)).rawValue() == 21845);
+	}
+}
+
+void runFixedTests()
+{
+	testWideProducts();
+}
@@ -0,0 +1,93 @@
+#include <stdint.h>
+#include <string.h>
+#include "FrameArena.h"
+#include "Tests.h"
+
+namespace
+{
+	void testAllocate()
+	{
+		FrameArena arena(256);
+		void* a = arena.allocate(3, 1);
+		void* b = arena.allocate(8, 8);
+		CHECK(reinterpret_cast<uintptr_t>(b) % 8 == 0);
+		CHECK(static_cast<char*>(b) >= static_cast<char*>(a) + 3);
+
+		CHECK(!strcmp(arena.format("SCORE WAS:  %d", 17500), "SCORE WAS:  17500"));
+		CHECK(!strcmp(arena.format("%s", ""), ""));
+	}
+
+	/**
+	*  A frame that spills into extra blocks leaves one block big
+	*  enough for all of it, so the next frame fits without growing.
+	*/
+	void testResetMerges()
+	{
+		FrameArena arena(64);
+		for (int i = 0; i < 10; i++)
+		{
+			arena.allocate(48);
+		}
+		size_t spilled = arena.capacity();
+		CHECK(spilled > 64);
+
+		arena.reset();
+		CHECK(arena.used() == 0);
+		CHECK(arena.capacity() == spilled);
+		for (int i = 0; i < 10; i++)
+		{
+			arena.allocate(48);
+		}
+		CHECK(arena.capacity() == spilled);
+	}
+
+	void testScope()
+	{
+		FrameArena arena(1024);
+		arena.allocate(100);
+		size_t before = arena.used();
+		{
+			FrameScope scope(arena);
+			arena.allocate(200);
+			CHECK(arena.used() > before);
+		}
+		CHECK(arena.used() == before);
+	}
+
+	/**
+	*  The containers take every byte from the arena, and after a
+	*  reset the same capacity serves the next frame.
+	*/
+	void testContainers()
+	{
+		FrameArena arena(4096);
+		{
+			frame_vector<int> values{ FrameAllocator<int>(arena) };
+			for (int i = 0; i < 500; i++)
+			{
+				values.push_back(i);
+			}
+			CHECK(values.size() == 500 && values[499] == 499);
+
+			frame_string text{ FrameAllocator<char>(arena) };
+			text = "a string well past any small string buffer";
+			text += arena.format(" %d", 42);
+			CHECK(text == "a string well past any small string buffer 42");
+			CHECK(arena.used() >= 500 * sizeof(int) + text.size());
+		}
+
+		size_t capacity = arena.capacity();
+		arena.reset();
+		frame_vector<int> values{ FrameAllocator<int>(arena) };
+		values.assign(500, 1);
+		CHECK(arena.capacity() == capacity);
+	}
+}
+
+void runFrameArenaTests()
+{
+	testAllocate();
+	testResetMerges();
+	testScope();
+	testContainers();
+}
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "PngCodec.h"
+#include "Tests.h"
+
+namespace
+{
+	struct Fixture
+	{
+		const char* name;
+		int width;
+		int height;
+	};
+
+	/**
+	*  Every colour type at a spread of depths, written by
+	*  Tests/Data/make_fixtures.py with the RGBA each should decode to.
+	*  The rows cycle through all five filters.
+	*/
+	const Fixture fixtures[] = {
+		{ "grey1", 19, 6 },
+		{ "grey4", 11, 5 },
+		{ "grey16", 7, 5 },
+		{ "rgb8", 9, 7 },
+		{ "rgb16", 5, 6 },
+		{ "palette2", 13, 5 },
+		{ "palette8", 8, 8 },
+		{ "grey_alpha8", 6, 5 },
+		{ "grey_alpha16", 5, 5 },
+		{ "rgba8", 12, 10 },
+		{ "rgba16", 4, 6 },
+	};
+
+	std::vector<unsigned char> readData(const std::string& name)
+	{
+		std::vector<unsigned char> data;
+		FILE* file = fopen(testDataPath(name.c_str()).c_str(), "rb");
+		if (file)
+		{
+			unsigned char buffer[4096];
+			size_t read;
+			while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+			{
+				data.insert(data.end(), buffer, buffer + read);
+			}
+			fclose(file);
+		}
+		return data;
+	}
+
+	bool matches(const Image& image, const std::vector<unsigned char>& expected)
+	{
+		return !expected.empty() && image.pixels.size() == expected.size() &&
+			!memcmp(image.pixels.data(), expected.data(), expected.size());
+	}
+
+	void testFixtures()
+	{
+		for (const Fixture& fixture : fixtures)
+		{
+			std::string name = fixture.name;
+			Image image;
+			if (!CHECK(loadPng(testDataPath((name + ".png").c_str()), image)))
+			{
+				fprintf(stderr, "  %s.png\n", fixture.name);
+				continue;
+			}
+
+			bool same = CHECK(image.width == fixture.width && image.height == fixture.height) &&
+				CHECK(matches(image, readData(name + ".rgba")));
+			if (!same)
+			{
+				fprintf(stderr, "  %s.png\n", fixture.name);
+			}
+		}
+	}
+
+	void testPremultiply()
+	{
+		Image image;
+		CHECK(loadPng(testDataPath("rgba8.png"), image, true));
+		CHECK(matches(image, readData("rgba8.premultiplied.rgba")));
+	}
+
+	/**
+	*  Headers claiming more pixels than the file could hold must be
+	*  refused before anything is allocated for them.
+	*/
+	void testCorruptDimensions()
+	{
+		// 16777216 x 16777216 with a three byte IDAT
+		Image image;
+		CHECK(!loadPng(testDataPath("huge_dimensions.png"), image));
+		CHECK(image.pixels.empty());
+
+		// 8192 x 8192, within the pixel limit but with 39 bytes of IDAT
+		CHECK(!loadPng(testDataPath("short_data.png"), image));
+		CHECK(image.pixels.empty());
+	}
+}
+
+void runPngTests()
+{
+	testFixtures();
+	testPremultiply();
+	testCorruptDimensions();
+}
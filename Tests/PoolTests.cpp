@@ -0,0 +1,136 @@
+#include <vector>
+#include "Pool.h"
+#include "Tests.h"
+
+namespace
+{
+	/**
+	*  Counts how many are alive, so leaks and double destruction show.
+	*/
+	struct Counted
+	{
+		static int alive;
+		int value;
+
+		explicit Counted(int value) : value(value) { alive++; }
+		~Counted() { alive--; }
+	};
+
+	int Counted::alive = 0;
+
+	/**
+	*  A released slot is handed out again, and the handle that held it
+	*  before no longer finds anything, nor can it release the new
+	*  object. Default and out of range handles are never valid.
+	*/
+	void testStaleHandles()
+	{
+		Pool<Counted> pool(4);
+		Pool<Counted>::Handle none;
+		CHECK(!pool.isValid(none));
+
+		Pool<Counted>::Handle first = pool.acquire(1);
+		Pool<Counted>::Handle second = pool.acquire(2);
+		CHECK(!pool.isValid(none));
+		CHECK(pool.get(first)->value == 1);
+		CHECK(pool.get(second)->value == 2);
+
+		pool.release(first);
+		CHECK(!pool.isValid(first));
+		CHECK(pool.get(first) == nullptr);
+		CHECK(pool.size() == 1);
+		CHECK(Counted::alive == 1);
+
+		Pool<Counted>::Handle reused = pool.acquire(3);
+		CHECK(reused.index == first.index);
+		CHECK(reused != first);
+		CHECK(pool.get(first) == nullptr);
+		CHECK(pool.get(reused)->value == 3);
+
+		pool.release(first);
+		CHECK(pool.isValid(reused));
+		CHECK(pool.size() == 2);
+
+		pool.release(reused);
+		pool.release(reused);
+		CHECK(pool.size() == 1);
+		CHECK(Counted::alive == 1);
+
+		Pool<Counted>::Handle beyond;
+		beyond.index = static_cast<uint32_t>(pool.capacity());
+		beyond.generation = 1;
+		CHECK(!pool.isValid(beyond));
+	}
+
+	/**
+	*  Objects don't move when more slabs are added, and whatever is
+	*  still alive is destroyed with the pool.
+	*/
+	void testSlabs()
+	{
+		{
+			Pool<Counted> pool(3);
+			std::vector<Pool<Counted>::Handle> handles;
+			std::vector<Counted*> pointers;
+			for (int i = 0; i < 10; i++)
+			{
+				handles.push_back(pool.acquire(i));
+				pointers.push_back(pool.get(handles.back()));
+			}
+
+			CHECK(pool.capacity() == 12);
+			for (int i = 0; i < 10; i++)
+			{
+				CHECK(pool.get(handles[i]) == pointers[i]);
+				CHECK(pointers[i]->value == i);
+			}
+
+			for (int i = 0; i < 10; i += 2)
+			{
+				pool.release(handles[i]);
+			}
+			for (int i = 0; i < 5; i++)
+			{
+				pool.acquire(100 + i);
+			}
+			CHECK(pool.capacity() == 12);
+			CHECK(pool.size() == 10);
+			CHECK(Counted::alive == 10);
+		}
+
+		CHECK(Counted::alive == 0);
+	}
+
+	/**
+	*  Generations count up, and wrap past 2^32 - 1 to 1 rather than 0,
+	*  the generation of a default handle.
+	*/
+	void testGenerationWrap()
+	{
+		CHECK(Pool<int>::nextGeneration(1) == 2);
+		CHECK(Pool<int>::nextGeneration(0xfffffffe) == 0xffffffff);
+		CHECK(Pool<int>::nextGeneration(0xffffffff) == 1);
+
+		Pool<int> pool(1);
+		Pool<int>::Handle handle = pool.acquire(0);
+		uint32_t generation = handle.generation;
+		bool counted = true;
+		for (int i = 0; i < 1000; i++)
+		{
+			pool.release(handle);
+			handle = pool.acquire(i);
+			generation = Pool<int>::nextGeneration(generation);
+			counted = counted && handle.generation == generation;
+		}
+		CHECK(counted);
+		CHECK(handle.index == 0);
+		CHECK(pool.capacity() == 1);
+	}
+}
+
+void runPoolTests()
+{
+	testStaleHandles();
+	testSlabs();
+	testGenerationWrap();
+}
@@ -0,0 +1,112 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "RectBatch.h"
+#include "Tests.h"
+
+namespace
+{
+	/**
+	*  Whole numbers from a small range, so edges often touch exactly
+	*  and the inclusive comparisons are exercised.
+	*/
+	real randomCoordinate(int range)
+	{
+		return real(rand() % range - range / 4);
+	}
+
+	rect randomRect()
+	{
+		rect r;
+		r.x = randomCoordinate(64);
+		r.y = randomCoordinate(64);
+		r.length = real(rand() % 16);
+		r.height = real(rand() % 16);
+		return r;
+	}
+
+	/**
+	*  Runs every kernel this CPU has over random batches of every
+	*  length up to a few vectors, so the tails are covered too, and
+	*  compares each with rect::isInside one rectangle at a time.
+	*/
+	void testKernelsMatchScalar()
+	{
+		const char* previous = overlapKernelName();
+		const char* kernels[] = { "scalar", "sse2", "avx2" };
+		srand(6);
+
+		for (const char* kernel : kernels)
+		{
+			if (!useOverlapKernel(kernel))
+			{
+				printf("  overlap kernel %s not available, skipped\n", kernel);
+				continue;
+			}
+
+			bool masks_match = true;
+			bool counts_match = true;
+			bool firsts_match = true;
+			for (int round = 0; round < 400; round++)
+			{
+				int count = round % 75;
+				std::vector<real> x(count), y(count), length(count), height(count);
+				std::vector<uint64_t> expected((count + 63) / 64 + 1, 0);
+				expected.back() = 0x5a5a5a5a5a5a5a5aull;
+				for (int i = 0; i < count; i++)
+				{
+					rect r = randomRect();
+					x[i] = r.x;
+					y[i] = r.y;
+					length[i] = r.length;
+					height[i] = r.height;
+				}
+
+				rect_batch batch;
+				batch.x = x.data();
+				batch.y = y.data();
+				batch.length = length.data();
+				batch.height = height.data();
+				batch.count = count;
+
+				rect r = randomRect();
+				int hits = 0;
+				int first = -1;
+				for (int i = 0; i < count; i++)
+				{
+					rect other;
+					other.x = x[i];
+					other.y = y[i];
+					other.length = length[i];
+					other.height = height[i];
+					if (r.isInside(other))
+					{
+						expected[i >> 6] |= uint64_t(1) << (i & 63);
+						hits++;
+						first = first < 0 ? i : first;
+					}
+				}
+
+				// one spare word past the end, which must be left alone
+				std::vector<uint64_t> mask(expected.size(), ~uint64_t(0));
+				mask.back() = expected.back();
+				counts_match = counts_match && overlapMask(r, batch, mask.data()) == hits;
+				masks_match = masks_match && mask == expected;
+				firsts_match = firsts_match && firstOverlap(r, batch) == first;
+			}
+
+			CHECK(masks_match);
+			CHECK(counts_match);
+			CHECK(firsts_match);
+		}
+
+		CHECK(useOverlapKernel(previous));
+	}
+}
+
+void runRectBatchTests()
+{
+	testKernelsMatchScalar();
+}
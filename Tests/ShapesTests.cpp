@@ -0,0 +1,156 @@
+#include <stdlib.h>
+#include "Shapes.h"
+#include "Tests.h"
+
+namespace
+{
+	const float tolerance = 0.01f;
+
+	bool near(real value, float expected)
+	{
+		return absReal(value - real(expected)) < real(tolerance);
+	}
+
+	rect target()
+	{
+		rect box;
+		box.x = 0;
+		box.y = 0;
+		box.length = 10;
+		box.height = 10;
+		return box;
+	}
+
+	circle makeCircle(real x, real y, real radius)
+	{
+		circle c;
+		c.x = x;
+		c.y = y;
+		c.radius = radius;
+		return c;
+	}
+
+	/**
+	*  How far a point is from the nearest point of a rectangle, and
+	*  the direction from that point to it.
+	*/
+	real distanceTo(const rect& box, real x, real y, real& nx, real& ny)
+	{
+		real cx = x < box.x ? box.x : (x > box.x + box.length ? box.x + box.length : x);
+		real cy = y < box.y ? box.y : (y > box.y + box.height ? box.y + box.height : y);
+		real distance = sqrtReal((x - cx) * (x - cx) + (y - cy) * (y - cy));
+		nx = distance > 0 ? (x - cx) / distance : real(0);
+		ny = distance > 0 ? (y - cy) / distance : real(0);
+		return distance;
+	}
+
+	/**
+	*  A circle of radius 2 heading straight at each corner along the
+	*  diagonal meets the corner's arc, not a face, so its normal is
+	*  the diagonal. Its centre stops 2 short of the corner, at
+	*  (10 - sqrt 2) / 20 of the way.
+	*/
+	void testDiagonalCorners()
+	{
+		const float diagonal = 0.70710678f;
+		const float time = (10 - 1.41421356f) / 20;
+		const int corners[4][2] = { { -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 } };
+		for (const auto& corner : corners)
+		{
+			real start_x = corner[0] < 0 ? real(-10) : real(20);
+			real start_y = corner[1] < 0 ? real(-10) : real(20);
+			sweep_result result;
+			bool hit = sweepShape(makeCircle(start_x, start_y, 2), real(-corner[0] * 20),
+				real(-corner[1] * 20), target(), result);
+
+			CHECK(hit);
+			CHECK(near(result.time, time));
+			CHECK(near(result.normal_x, corner[0] * diagonal));
+			CHECK(near(result.normal_y, corner[1] * diagonal));
+		}
+	}
+
+	/**
+	*  Falling straight down one unit left of the box, a circle of
+	*  radius 2 catches the top left corner off centre. The contact is
+	*  1 across and sqrt 3 up from the corner, so the normal is
+	*  (-1, -sqrt 3) / 2, not the face's (0, -1).
+	*/
+	void testOffCentreCorner()
+	{
+		sweep_result result;
+		CHECK(sweepShape(makeCircle(-1, -10, 2), 0, 20, target(), result));
+		CHECK(near(result.time, (10 - 1.7320508f) / 20));
+		CHECK(near(result.normal_x, -0.5f));
+		CHECK(near(result.normal_y, -0.8660254f));
+
+		CHECK(sweepShape(makeCircle(5, -10, 2), 0, 20, target(), result));
+		CHECK(near(result.time, 0.4f));
+		CHECK(near(result.normal_x, 0));
+		CHECK(near(result.normal_y, -1));
+
+		CHECK(!sweepShape(makeCircle(-3, -10, 2), 0, 20, target(), result));
+		CHECK(!sweepShape(makeCircle(-1, -10, 2), 0, -20, target(), result));
+	}
+
+	/**
+	*  Random sweeps from outside the box. Where there's a hit, the
+	*  circle at the reported time must just touch the box, with the
+	*  normal pointing from the touching point to its centre, and
+	*  every earlier point of the path must be clear. Where there's
+	*  no hit, the whole path must be clear.
+	*/
+	void testRandomSweeps()
+	{
+		srand(9);
+		bool touching = true;
+		bool normals = true;
+		bool clear = true;
+		int hits = 0;
+		for (int i = 0; i < 2000; i++)
+		{
+			real radius = real(1 + rand() % 6);
+			real x = real(rand() % 60 - 25);
+			real y = real(rand() % 60 - 25);
+			real nx, ny;
+			if (distanceTo(target(), x, y, nx, ny) <= radius + real(tolerance))
+			{
+				continue;
+			}
+
+			real dx = real(rand() % 81 - 40);
+			real dy = real(rand() % 81 - 40);
+			sweep_result result;
+			bool hit = sweepShape(makeCircle(x, y, radius), dx, dy, target(), result);
+			real end = hit ? result.time : real(1);
+			if (hit)
+			{
+				hits++;
+				real at_x = x + dx * result.time;
+				real at_y = y + dy * result.time;
+				touching = touching && absReal(distanceTo(target(), at_x, at_y, nx, ny) - radius) < real(tolerance);
+				normals = normals && absReal(result.normal_x - nx) < real(tolerance) &&
+					absReal(result.normal_y - ny) < real(tolerance) &&
+					dx * result.normal_x + dy * result.normal_y < 0;
+			}
+
+			for (int sample = 0; sample <= 32; sample++)
+			{
+				real t = end * sample / 32;
+				clear = clear && distanceTo(target(), x + dx * t, y + dy * t, nx, ny) > radius - real(tolerance);
+			}
+		}
+
+		CHECK(hits > 200);
+		CHECK(touching);
+		CHECK(normals);
+		CHECK(clear);
+	}
+}
+
+void runShapesTests()
+{
+	testDiagonalCorners();
+	testOffCentreCorner();
+	testRandomSweeps();
+}
@@ -0,0 +1,115 @@
+#include <stdlib.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "SortAndSweep.h"
+#include "Tests.h"
+
+namespace
+{
+	const int object_count = 120;
+
+	rect randomRect()
+	{
+		rect r;
+		r.x = real(rand() % 400);
+		r.y = real(rand() % 400);
+		r.length = real(rand() % 40);
+		r.height = real(rand() % 40);
+		return r;
+	}
+
+	/**
+	*  Every pair of live objects whose bounds touch, lower id first,
+	*  found by testing each pair.
+	*/
+	std::vector<std::pair<int, int>> bruteForcePairs(const std::vector<rect>& bounds,
+		const std::vector<bool>& live)
+	{
+		std::vector<std::pair<int, int>> pairs;
+		for (int a = 0; a < object_count; a++)
+		{
+			for (int b = a + 1; b < object_count; b++)
+			{
+				if (live[a] && live[b] && bounds[a].isInside(bounds[b]))
+				{
+					pairs.push_back(std::make_pair(a, b));
+				}
+			}
+		}
+		return pairs;
+	}
+
+	/**
+	*  Objects are moved a little, as balls are between ticks, or
+	*  jumped anywhere, inserted and removed. findPairs must give
+	*  exactly the O(n^2) pairs in the same order, and queries exactly
+	*  the objects a scan finds, whether or not the order is sorted.
+	*/
+	void testAgainstBruteForce()
+	{
+		SortAndSweep broadphase;
+		std::vector<rect> bounds(object_count);
+		std::vector<bool> live(object_count, false);
+		srand(11);
+
+		bool pairs_match = true;
+		bool queries_match = true;
+		std::vector<std::pair<int, int>> pairs;
+		std::vector<int> results;
+		for (int step = 0; step < 600; step++)
+		{
+			for (int change = 0; change < 10; change++)
+			{
+				int id = rand() % object_count;
+				int action = rand() % 6;
+				if (action == 0)
+				{
+					broadphase.remove(id);
+					live[id] = false;
+				}
+				else if (action == 1 || !live[id])
+				{
+					bounds[id] = randomRect();
+					broadphase.update(id, bounds[id]);
+					live[id] = true;
+				}
+				else
+				{
+					bounds[id].x += real(rand() % 9 - 4);
+					bounds[id].y += real(rand() % 9 - 4);
+					broadphase.update(id, bounds[id]);
+				}
+			}
+
+			rect area = randomRect();
+			broadphase.query(area, results);
+			std::sort(results.begin(), results.end());
+			std::vector<int> expected;
+			for (int id = 0; id < object_count; id++)
+			{
+				if (live[id] && area.isInside(bounds[id]))
+				{
+					expected.push_back(id);
+				}
+			}
+			queries_match = queries_match && results == expected;
+
+			broadphase.findPairs(pairs);
+			pairs_match = pairs_match && pairs == bruteForcePairs(bounds, live);
+		}
+
+		CHECK(pairs_match);
+		CHECK(queries_match);
+		CHECK(!pairs.empty());
+
+		broadphase.clear();
+		broadphase.findPairs(pairs);
+		CHECK(pairs.empty());
+	}
+}
+
+void runSortAndSweepTests()
+{
+	testAgainstBruteForce();
+}
@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include "Tests.h"
+
+namespace
+{
+	int checks = 0;
+	int failures = 0;
+}
+
+bool checkTest(bool passed, const char* expression, const char* file, int line)
+{
+	checks++;
+	if (!passed)
+	{
+		failures++;
+		fprintf(stderr, "%s:%d: failed: %s\n", file, line, expression);
+	}
+	return passed;
+}
+
+std::string testDataPath(const char* name)
+{
+	return std::string(BREAKOUT_TEST_DATA) + "/" + name;
+}
+
+std::string testOutputPath(const char* name)
+{
+	return std::string(BREAKOUT_TEST_OUTPUT) + "/" + name;
+}
+
+int main()
+{
+	runAssetPackTests();
+	runAtlasTests();
+	runEntityStoreTests();
+	runFixedTests();
+	runFrameArenaTests();
+	runPngTests();
+	runPoolTests();
+	runRectBatchTests();
+	runShapesTests();
+	runSimulationTests();
+	runSortAndSweepTests();
+	runTimerWheelTests();
+	runUniformGridTests();
+	runVectorTests();
+
+	printf("%d checks, %d failed\n", checks, failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+
+/**
+*  A minimal test runner for the headless build.
+*  Each test file adds a run function below, called once by main().
+*  CHECK records a failure and carries on, so one run reports every
+*  broken case. Built by CMake as breakout_tests and run by ctest.
+*/
+#define CHECK(condition) checkTest((condition), #condition, __FILE__, __LINE__)
+
+/**
+*  Records the result of a check, printing it if it failed.
+*  @return passed, so a test can stop early on a failed check.
+*/
+bool checkTest(bool passed, const char* expression, const char* file, int line);
+
+/**
+*  The path of a file in Tests/Data.
+*/
+std::string testDataPath(const char* name);
+
+/**
+*  The path of a scratch file in the build directory.
+*/
+std::string testOutputPath(const char* name);
+
+void runAssetPackTests();
+void runAtlasTests();
+void runEntityStoreTests();
+void runFixedTests();
+void runFrameArenaTests();
+void runPngTests();
+void runPoolTests();
+void runRectBatchTests();
+void runShapesTests();
+void runSimulationTests();
+void runSortAndSweepTests();
+void runTimerWheelTests();
+void runUniformGridTests();
+void runVectorTests();
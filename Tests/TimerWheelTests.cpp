@@ -0,0 +1,193 @@
+#include <stdint.h>
+#include <vector>
+#include "TimerWheel.h"
+#include "Tests.h"
+
+namespace
+{
+	uint64_t random_state = 88172645463325252ull;
+
+	uint64_t nextRandom(uint64_t range)
+	{
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 7;
+		random_state ^= random_state << 17;
+		return random_state % range;
+	}
+
+	/**
+	*  Delays spread across every wheel and the overflow list.
+	*/
+	uint64_t randomDelay()
+	{
+		switch (nextRandom(6))
+		{
+		case 0: return nextRandom(4);
+		case 1: return nextRandom(64);
+		case 2: return nextRandom(4096);
+		case 3: return nextRandom(262144);
+		case 4: return nextRandom(uint64_t(1) << 24);
+		default: return (uint64_t(1) << 24) + nextRandom(uint64_t(1) << 26);
+		}
+	}
+
+	uint64_t randomStep()
+	{
+		switch (nextRandom(4))
+		{
+		case 0: return 1;
+		case 1: return nextRandom(100);
+		case 2: return nextRandom(5000);
+		default: return nextRandom(uint64_t(1) << 20);
+		}
+	}
+
+	/**
+	*  The plain version: every timer in a list with its expiry. Each
+	*  advance should fire exactly the pending timers due by the new
+	*  clock, in order of expiry, each on the tick it's due.
+	*/
+	struct Expected
+	{
+		TimerId  id;
+		uint64_t expiry;
+		bool     pending;
+	};
+
+	struct Checker
+	{
+		TimerWheel<int> wheel;
+		std::vector<Expected> timers;
+		bool fired_on_time = true;
+		bool fired_in_order = true;
+		uint64_t last_fired = 0;
+
+		void schedule(uint64_t delay)
+		{
+			Expected timer;
+			timer.id = wheel.schedule(delay, static_cast<int>(timers.size()));
+			timer.expiry = wheel.clock() + (delay > 0 ? delay : 1);
+			timer.pending = true;
+			timers.push_back(timer);
+		}
+
+		void cancel(int index)
+		{
+			bool cancelled = wheel.cancel(timers[index].id);
+			fired_on_time = fired_on_time && cancelled == timers[index].pending;
+			timers[index].pending = false;
+		}
+
+		/**
+		*  Some timers schedule or cancel others as they fire.
+		*/
+		void advance(uint64_t ticks)
+		{
+			last_fired = wheel.clock();
+			wheel.advance(ticks, [this](int fired)
+			{
+				Expected& timer = timers[fired];
+				fired_on_time = fired_on_time && timer.pending && timer.expiry == wheel.clock();
+				fired_in_order = fired_in_order && timer.expiry >= last_fired;
+				last_fired = timer.expiry;
+				timer.pending = false;
+
+				if (fired % 5 == 0)
+				{
+					schedule(nextRandom(200));
+				}
+				else if (fired % 7 == 0)
+				{
+					cancel(static_cast<int>(nextRandom(timers.size())));
+				}
+			});
+		}
+
+		bool agrees() const
+		{
+			int pending = 0;
+			bool agreed = true;
+			for (const Expected& timer : timers)
+			{
+				agreed = agreed && wheel.isPending(timer.id) == timer.pending &&
+					wheel.expiry(timer.id) == (timer.pending ? timer.expiry : 0) &&
+					(!timer.pending || timer.expiry > wheel.clock());
+				pending += timer.pending ? 1 : 0;
+			}
+			return agreed && wheel.size() == pending;
+		}
+	};
+
+	void testAgainstList()
+	{
+		Checker checker;
+		bool agreed = true;
+		uint64_t clock = 0;
+		for (int step = 0; step < 4000; step++)
+		{
+			switch (nextRandom(4))
+			{
+			case 0:
+			case 1:
+				checker.schedule(randomDelay());
+				break;
+			case 2:
+				if (!checker.timers.empty())
+				{
+					checker.cancel(static_cast<int>(nextRandom(checker.timers.size())));
+				}
+				break;
+			default:
+				uint64_t ticks = randomStep();
+				checker.advance(ticks);
+				clock += ticks;
+				agreed = agreed && checker.wheel.clock() == clock;
+				break;
+			}
+			agreed = agreed && checker.agrees();
+		}
+
+		// run everything still pending out, across the overflow list
+		checker.advance(uint64_t(1) << 28);
+		CHECK(agreed);
+		CHECK(checker.agrees());
+		CHECK(checker.fired_on_time);
+		CHECK(checker.fired_in_order);
+		CHECK(checker.wheel.size() == 0);
+	}
+
+	/**
+	*  Timers due now fire on the next tick, and a timer scheduled from
+	*  inside fire for a tick within the same advance fires in it.
+	*/
+	void testEdges()
+	{
+		TimerWheel<int> wheel;
+		std::vector<int> fired;
+		wheel.schedule(0, 1);
+		wheel.advance(0, [&](int value) { fired.push_back(value); });
+		CHECK(fired.empty());
+		wheel.advance(1, [&](int value) { fired.push_back(value); });
+		CHECK(fired.size() == 1);
+
+		TimerId again = wheel.schedule(64, 2);
+		wheel.advance(64, [&](int value)
+		{
+			fired.push_back(value);
+			if (value == 2)
+			{
+				wheel.schedule(64, 3);
+			}
+		});
+		CHECK(fired.size() == 2 && wheel.size() == 1);
+		CHECK(!wheel.cancel(again));
+		wheel.advance(64, [&](int value) { fired.push_back(value); });
+		CHECK(fired.size() == 3 && fired[2] == 3);
+	}
+}
+
+void runTimerWheelTests()
+{
+	testAgainstList();
+	testEdges();
+}
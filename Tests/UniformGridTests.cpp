@@ -0,0 +1,160 @@
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include "UniformGrid.h"
+#include "Tests.h"
+
+namespace
+{
+	const int object_count = 300;
+	const int cell_size = 32;
+
+	real randomCoordinate(int range)
+	{
+		return real(rand() % range);
+	}
+
+	rect randomRect(int range, int size)
+	{
+		rect r;
+		r.x = randomCoordinate(range);
+		r.y = randomCoordinate(range);
+		r.length = real(rand() % size);
+		r.height = real(rand() % size);
+		return r;
+	}
+
+	/**
+	*  Checks one query against every live object. The grid may return
+	*  extra candidates, but only live ones from the cells around the
+	*  area, each once, and never leave out one that overlaps.
+	*/
+	bool queryMatches(const UniformGrid& grid, const rect& area,
+		const std::vector<rect>& bounds, const std::vector<bool>& live)
+	{
+		std::vector<int> results;
+		grid.query(area, results);
+
+		std::vector<int> sorted = results;
+		std::sort(sorted.begin(), sorted.end());
+		if (std::unique(sorted.begin(), sorted.end()) != sorted.end())
+		{
+			return false;
+		}
+
+		rect near = area;
+		near.x -= cell_size;
+		near.y -= cell_size;
+		near.length += cell_size * 2;
+		near.height += cell_size * 2;
+		for (int id : results)
+		{
+			if (id < 0 || id >= object_count || !live[id] || !near.isInside(bounds[id]))
+			{
+				return false;
+			}
+		}
+
+		for (int id = 0; id < object_count; id++)
+		{
+			if (live[id] && area.isInside(bounds[id]) &&
+				!std::binary_search(sorted.begin(), sorted.end(), id))
+			{
+				return false;
+			}
+		}
+
+		std::vector<int> concurrent;
+		grid.queryConcurrent(area, concurrent);
+		std::sort(concurrent.begin(), concurrent.end());
+		return concurrent == sorted;
+	}
+
+	/**
+	*  Random inserts, moves and removes, each of which reshuffles the
+	*  cells' lists, with queries compared to a brute force search
+	*  after every change.
+	*/
+	void testAgainstBruteForce()
+	{
+		UniformGrid grid;
+		rect world;
+		world.length = 512;
+		world.height = 512;
+		grid.resize(world, cell_size, cell_size);
+		srand(4);
+
+		std::vector<rect> bounds(object_count);
+		std::vector<bool> live(object_count, false);
+		bool matched = true;
+		for (int step = 0; step < 2000; step++)
+		{
+			int id = rand() % object_count;
+			if (rand() % 3 == 0)
+			{
+				grid.remove(id);
+				live[id] = false;
+			}
+			else
+			{
+				bounds[id] = randomRect(480, 48);
+				grid.insert(id, bounds[id]);
+				live[id] = true;
+			}
+
+			for (int query = 0; query < 4; query++)
+			{
+				matched = matched && queryMatches(grid, randomRect(512, 128), bounds, live);
+			}
+		}
+
+		CHECK(matched);
+
+		grid.clear();
+		std::vector<int> results;
+		grid.query(world, results);
+		CHECK(results.empty());
+	}
+
+	/**
+	*  Objects partly or wholly outside the grid are kept in the border
+	*  cells, so they are still found.
+	*/
+	void testOutsideBounds()
+	{
+		UniformGrid grid;
+		rect world;
+		world.length = 128;
+		world.height = 128;
+		grid.resize(world, cell_size, cell_size);
+
+		rect left;
+		left.x = -100;
+		left.y = 10;
+		left.length = 20;
+		left.height = 20;
+		rect below;
+		below.x = 60;
+		below.y = 400;
+		below.length = 10;
+		below.height = 10;
+		grid.insert(0, left);
+		grid.insert(1, below);
+
+		std::vector<int> results;
+		grid.query(left, results);
+		CHECK(std::find(results.begin(), results.end(), 0) != results.end());
+		grid.query(below, results);
+		CHECK(std::find(results.begin(), results.end(), 1) != results.end());
+
+		grid.remove(0);
+		grid.query(left, results);
+		CHECK(results.empty());
+	}
+}
+
+void runUniformGridTests()
+{
+	testAgainstBruteForce();
+	testOutsideBounds();
+}
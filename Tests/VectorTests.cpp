@@ -0,0 +1,84 @@
+#include <vector>
+#include "Tests.h"
+#include "Vector2.h"
+
+namespace
+{
+	const int count = 37;   /**< Odd, so the scalar tail runs after the pairs. */
+
+	unsigned int rng = 13;
+	real randomReal()
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		return real(static_cast<int>(rng % 2001) - 1000) / 10;
+	}
+
+	std::vector<vec2> randomVectors()
+	{
+		std::vector<vec2> v(count);
+		for (vec2& value : v)
+		{
+			value = vec2(randomReal(), randomReal());
+		}
+		v[3] = vec2();
+		v[4] = vec2();
+		return v;
+	}
+
+	bool near(real a, real b)
+	{
+		real scale = absReal(a) > 1 ? absReal(a) : real(1);
+		return absReal(a - b) <= scale / 100000;
+	}
+
+	bool near(vec2 a, vec2 b)
+	{
+		return near(a.x, b.x) && near(a.y, b.y);
+	}
+
+	/**
+	*  The batch functions take the SSE2 path in float builds, and must
+	*  give what the scalar functions give one vector at a time.
+	*/
+	void testBatchMatchesScalar()
+	{
+		std::vector<vec2> a = randomVectors();
+		std::vector<vec2> b = randomVectors();
+
+		std::vector<vec2> moved = a;
+		addScaled(moved.data(), b.data(), real(0.25), count);
+		std::vector<real> dots(count);
+		dotAll(a.data(), b.data(), dots.data(), count);
+		std::vector<vec2> normals = b;
+		normaliseAll(normals.data(), count);
+
+		for (int i = 0; i < count; i++)
+		{
+			CHECK(near(moved[i], a[i] + b[i] * real(0.25)));
+			CHECK(near(dots[i], dot(a[i], b[i])));
+			CHECK(near(normals[i], normalise(b[i])));
+		}
+		CHECK(normals[3] == vec2());
+
+		// normals must be unit length, and about half face each way
+		std::vector<vec2> reflected = a;
+		reflectAll(reflected.data(), normals.data(), count);
+		for (int i = 0; i < count; i++)
+		{
+			if (normals[i] == vec2())
+			{
+				continue;
+			}
+
+			vec2 expected = dot(a[i], normals[i]) < 0 ? reflect(a[i], normals[i]) : a[i];
+			CHECK(near(reflected[i], expected));
+		}
+	}
+}
+
+void runVectorTests()
+{
+	testBatchMatchesScalar();
+}